@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2015 Motorola Mobility, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Greybus core benchmark
+ *
+ * Runs over the simulated transport, where cports 2n and 2n + 1 are connected
+ * back to back: the client threads send requests on the even cports and the
+ * same driver answers them on the odd cports.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arch/atomic.h>
+#include <nuttx/greybus/greybus.h>
+#include <nuttx/util.h>
+
+#define GB_BENCH_TYPE_REQUEST   0x02
+#define GB_BENCH_HEAP_SAMPLING  64 /* sample the heap usage every n requests */
+#define GB_BENCH_DRAIN_TIMEOUT  5000 /* ms */
+
+struct gb_bench_params {
+    size_t size;
+    unsigned int cports;        /* number of cport pairs */
+    unsigned int ratio;         /* percentage of requests with a response */
+    unsigned int threads;       /* client threads per cport pair */
+    unsigned int count;         /* requests per client thread */
+};
+
+struct gb_bench_client {
+    pthread_t thread;
+    unsigned int cport;
+    uint32_t *latencies;
+    unsigned int nlatencies;
+    unsigned int sent;
+    unsigned int errors;
+};
+
+static struct gb_bench_params params;
+static atomic_t received;
+static int heap_peak;
+
+static uint8_t gb_bench_request_handler(struct gb_operation *operation)
+{
+    struct gb_operation_hdr *hdr = operation->request_buffer;
+    size_t size = gb_operation_get_request_payload_size(operation);
+
+    atomic_inc(&received);
+
+    if (!hdr->id)
+        return GB_OP_SUCCESS;
+
+    if (!gb_operation_alloc_response(operation, size))
+        return GB_OP_NO_MEMORY;
+
+    memcpy(gb_operation_get_response_payload(operation),
+           gb_operation_get_request_payload(operation), size);
+
+    return GB_OP_SUCCESS;
+}
+
+static struct gb_operation_handler gb_bench_handlers[] = {
+    GB_HANDLER(GB_BENCH_TYPE_REQUEST, gb_bench_request_handler),
+};
+
+static struct gb_driver gb_bench_driver = {
+    .op_handlers = gb_bench_handlers,
+    .op_handlers_count = ARRAY_SIZE(gb_bench_handlers),
+};
+
+static int gb_bench_heap_used(void)
+{
+#ifdef CONFIG_CAN_PASS_STRUCTS
+    struct mallinfo info = mallinfo();
+#else
+    struct mallinfo info;
+
+    mallinfo(&info);
+#endif
+
+    return info.uordblks;
+}
+
+static void gb_bench_sample_heap(void)
+{
+    int used = gb_bench_heap_used();
+
+    if (used > heap_peak)
+        heap_peak = used;
+}
+
+static uint32_t gb_bench_elapsed_us(const struct timespec *start,
+                                    const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1000000 +
+           (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void *gb_bench_client_thread(void *data)
+{
+    struct gb_bench_client *client = data;
+    struct gb_operation *operation;
+    struct timespec start, end;
+    bool need_response;
+    unsigned int i;
+    int retval;
+
+    for (i = 0; i < params.count; i++) {
+        need_response = (i % 100) < params.ratio;
+
+        operation = gb_operation_create(client->cport, GB_BENCH_TYPE_REQUEST,
+                                        params.size);
+        if (!operation) {
+            client->errors++;
+            continue;
+        }
+
+        memset(gb_operation_get_request_payload(operation), i, params.size);
+
+        if (need_response) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            retval = gb_operation_send_request_sync(operation);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            if (retval ||
+                gb_operation_get_response_result(operation) != GB_OP_SUCCESS) {
+                client->errors++;
+            } else {
+                client->latencies[client->nlatencies++] =
+                    gb_bench_elapsed_us(&start, &end);
+                client->sent++;
+            }
+        } else {
+            retval = gb_operation_send_request(operation, NULL, false);
+            if (retval)
+                client->errors++;
+            else
+                client->sent++;
+        }
+
+        gb_operation_destroy(operation);
+
+        if (!(i % GB_BENCH_HEAP_SAMPLING))
+            gb_bench_sample_heap();
+    }
+
+    return NULL;
+}
+
+static int gb_bench_setup(void)
+{
+    static bool initialized;
+    unsigned int cport;
+    int retval;
+
+    if (initialized)
+        return 0;
+
+    retval = gb_sim_backend_init();
+    if (retval)
+        return retval;
+
+    for (cport = 0; cport < CONFIG_GREYBUS_SIM_NUM_CPORTS; cport++) {
+        retval = gb_register_driver(cport, &gb_bench_driver);
+        if (retval)
+            return retval;
+
+        retval = gb_listen(cport);
+        if (retval)
+            return retval;
+    }
+
+    initialized = true;
+    return 0;
+}
+
+static int compare_latencies(const void *a, const void *b)
+{
+    uint32_t la = *(const uint32_t *) a;
+    uint32_t lb = *(const uint32_t *) b;
+
+    return la < lb ? -1 : la > lb;
+}
+
+static uint32_t percentile(const uint32_t *latencies, unsigned int n,
+                           unsigned int per_mille)
+{
+    if (!n)
+        return 0;
+
+    return latencies[(uint64_t) (n - 1) * per_mille / 1000];
+}
+
+static void gb_bench_report(struct gb_bench_client *clients,
+                            unsigned int nclients, uint32_t elapsed_us,
+                            int heap_before, int heap_after)
+{
+    unsigned int sent = 0, errors = 0, nlatencies = 0;
+    uint32_t *latencies;
+    unsigned int i;
+    uint64_t rate = 0;
+
+    /* Pack the latencies of all the clients at the start of the array */
+    latencies = clients[0].latencies;
+    for (i = 0; i < nclients; i++) {
+        sent += clients[i].sent;
+        errors += clients[i].errors;
+        memmove(latencies + nlatencies, clients[i].latencies,
+                clients[i].nlatencies * sizeof(*latencies));
+        nlatencies += clients[i].nlatencies;
+    }
+
+    qsort(latencies, nlatencies, sizeof(*latencies), compare_latencies);
+
+    if (elapsed_us)
+        rate = (uint64_t) atomic_get(&received) * 1000000 / elapsed_us;
+
+    printf("gb_bench: %u cport pairs, %u threads per pair, %zu bytes, "
+           "%u%% with response\n", params.cports, params.threads,
+           params.size, params.ratio);
+    printf("messages: %u sent, %u received, %u errors in %u ms\n",
+           sent, atomic_get(&received), errors, elapsed_us / 1000);
+    printf("throughput: %llu msg/s, %llu B/s\n", (unsigned long long) rate,
+           (unsigned long long) rate * params.size);
+    printf("latency (us): p50 %u p99 %u p999 %u max %u\n",
+           percentile(latencies, nlatencies, 500),
+           percentile(latencies, nlatencies, 990),
+           percentile(latencies, nlatencies, 999),
+           percentile(latencies, nlatencies, 1000));
+    printf("heap (bytes): %d before, %d peak, %d after\n",
+           heap_before, heap_peak, heap_after);
+}
+
+static void show_usage(const char *appname)
+{
+    printf("%s [-s size] [-c cports] [-r ratio] [-t threads] [-n count]\n",
+           appname);
+    printf("\t-s: payload size of the requests (default 64)\n");
+    printf("\t-c: number of cport pairs exercised (default 1, max %d)\n",
+           CONFIG_GREYBUS_SIM_NUM_CPORTS / 2);
+    printf("\t-r: percentage of requests waiting for a response "
+           "(default 100)\n");
+    printf("\t-t: client threads per cport pair (default 1)\n");
+    printf("\t-n: requests sent by each client thread (default 1000)\n");
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int gb_bench_main(int argc, char *argv[])
+#endif
+{
+    struct gb_bench_client *clients;
+    struct timespec start, end;
+    unsigned int nclients, expected, i;
+    uint32_t *latencies;
+    int heap_before, heap_after;
+    int waited;
+    int opt;
+    int retval;
+
+    params.size = 64;
+    params.cports = 1;
+    params.ratio = 100;
+    params.threads = 1;
+    params.count = 1000;
+
+    optind = -1;
+    while ((opt = getopt(argc, argv, "s:c:r:t:n:")) != -1) {
+        switch (opt) {
+        case 's':
+            params.size = strtoul(optarg, NULL, 10);
+            break;
+        case 'c':
+            params.cports = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            params.ratio = strtoul(optarg, NULL, 10);
+            break;
+        case 't':
+            params.threads = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            params.count = strtoul(optarg, NULL, 10);
+            break;
+        default:
+            show_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!params.cports || params.cports > CONFIG_GREYBUS_SIM_NUM_CPORTS / 2 ||
+        !params.threads || params.ratio > 100 ||
+        params.size > GB_MAX_PAYLOAD_SIZE) {
+        show_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    retval = gb_bench_setup();
+    if (retval) {
+        fprintf(stderr, "gb_bench: cannot setup greybus: %s\n",
+                strerror(-retval));
+        return EXIT_FAILURE;
+    }
+
+    nclients = params.cports * params.threads;
+    clients = zalloc(nclients * sizeof(*clients));
+    latencies = malloc(nclients * params.count * sizeof(*latencies));
+    if (!clients || !latencies) {
+        fprintf(stderr, "gb_bench: out of memory\n");
+        retval = -ENOMEM;
+        goto out;
+    }
+
+    atomic_init(&received, 0);
+    heap_before = gb_bench_heap_used();
+    heap_peak = heap_before;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < nclients; i++) {
+        clients[i].cport = (i % params.cports) * 2;
+        clients[i].latencies = latencies + i * params.count;
+
+        retval = pthread_create(&clients[i].thread, NULL,
+                                gb_bench_client_thread, &clients[i]);
+        if (retval) {
+            fprintf(stderr, "gb_bench: cannot start client: %s\n",
+                    strerror(retval));
+            nclients = i;
+            break;
+        }
+    }
+
+    expected = 0;
+    for (i = 0; i < nclients; i++) {
+        pthread_join(clients[i].thread, NULL);
+        expected += clients[i].sent;
+    }
+
+    /* Requests without response may still be on their way */
+    for (waited = 0; atomic_get(&received) < expected &&
+                     waited < GB_BENCH_DRAIN_TIMEOUT; waited++)
+        usleep(1000);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    gb_bench_sample_heap();
+    heap_after = gb_bench_heap_used();
+
+    if (nclients)
+        gb_bench_report(clients, nclients, gb_bench_elapsed_us(&start, &end),
+                        heap_before, heap_after);
+
+out:
+    free(latencies);
+    free(clients);
+
+    return retval ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -280,14 +280,16 @@ static void print_status_normal(void)
     struct loopback_context *ctx;
     struct list_head *iter;
 
-    printf("  CPORT    ACTIVE    RECV ERR    SEND ERR    SENT    RECV    THROUGHPUT   LATENCY   REQ_PER_SEC\n");
+    int stack_saved = 0;
+
+    printf("  CPORT    ACTIVE    RECV ERR    SEND ERR    SENT    RECV    THROUGHPUT   LATENCY   REQ_PER_SEC   DISPATCH P50/P90/P99\n");
     loopback_ctx_list_lock();
     list_foreach(&loopback_ctx_list, iter) {
         ctx = list_entry(iter, struct loopback_context, list);
 
         loopback_ctx_lock(ctx);
         gb_loopback_get_stats(ctx->cport, &stats);
-        printf("%7d %9s %11d %11d %7u %7u %13u %9u %13u\n",
+        printf("%7d %9s %11d %11d %7u %7u %13u %9u %13u %10u/%u/%u\n",
                ctx->cport,
                ctx->active ? "yes" : "no",
                stats.recv_err,
@@ -296,10 +298,16 @@ static void print_status_normal(void)
                stats.recv,
                stats.throughput_avg,
                stats.latency_avg,
-               stats.reqs_per_sec_avg);
+               stats.reqs_per_sec_avg,
+               stats.dispatch_p50,
+               stats.dispatch_p90,
+               stats.dispatch_p99);
+        stack_saved = stats.stack_saved;
         loopback_ctx_unlock(ctx);
     }
     loopback_ctx_list_unlock();
+
+    printf("\nStack saved by the worker pool: %d bytes\n", stack_saved);
 }
 
 static void print_status_csv(void)
@@ -309,14 +317,14 @@ static void print_status_csv(void)
     struct list_head *iter;
 
     printf("; generated by gbl\n");
-    printf("; iterations, errors, requests per second (min, max, avg, jitter), latency (min, max, avg, jitter), throughput (min, max, avg, jitter)\n");
+    printf("; iterations, errors, requests per second (min, max, avg, jitter), latency (min, max, avg, jitter), throughput (min, max, avg, jitter), dispatch latency (p50, p90, p99)\n");
     loopback_ctx_list_lock();
     list_foreach(&loopback_ctx_list, iter) {
         ctx = list_entry(iter, struct loopback_context, list);
 
         loopback_ctx_lock(ctx);
         gb_loopback_get_stats(ctx->cport, &stats);
-        printf("%d,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+        printf("%d,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
                stats.recv,
                stats.recv_err,
                stats.reqs_per_sec_min,
@@ -330,7 +338,10 @@ static void print_status_csv(void)
                stats.throughput_min,
                stats.throughput_max,
                stats.throughput_avg,
-               stats.throughput_max - stats.throughput_min);
+               stats.throughput_max - stats.throughput_min,
+               stats.dispatch_p50,
+               stats.dispatch_p90,
+               stats.dispatch_p99);
         loopback_ctx_unlock(ctx);
     }
     loopback_ctx_list_unlock();
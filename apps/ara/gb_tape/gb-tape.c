@@ -58,7 +58,11 @@ int gb_tape_main(int argc, char *argv[])
 
     optind = -1;
 
+#if defined(CONFIG_GREYBUS_TAPE_ARM_SEMIHOSTING)
     gb_tape_arm_semihosting_register();
+#elif defined(CONFIG_GREYBUS_TAPE_FILE)
+    gb_tape_file_register();
+#endif
 
     while ((c = getopt(argc, argv, "r:p:s")) != -1) {
         switch (c) {
@@ -75,6 +79,9 @@ int gb_tape_main(int argc, char *argv[])
             if (retval) {
                 fprintf(stderr, "gb_tape: stop taping error: %s\n",
                         strerror(retval));
+            } else if (gb_tape_dropped_records()) {
+                printf("gb_tape: %u records dropped\n",
+                       gb_tape_dropped_records());
             }
             break;
 
@@ -0,0 +1,433 @@
+/****************************************************************************
+ * examples/mm/mm_bench.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+#  include <nuttx/hires_tmr.h>
+#endif
+
+#ifdef CONFIG_EXAMPLES_MM_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NSLOTS       CONFIG_EXAMPLES_MM_BENCH_NSLOTS
+#define BENCH_NOPS         CONFIG_EXAMPLES_MM_BENCH_NOPS
+
+/* Latencies are counted in power-of-two buckets of microseconds:  0, 1,
+ * 2-3, 4-7... and BENCH_NBUCKETS-1 microseconds and above.
+ */
+
+#define BENCH_NBUCKETS     10
+
+/* The fragmentation is sampled every BENCH_SAMPLE operations */
+
+#define BENCH_SAMPLE       64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The synthetic trace mixes allocations of a few kinds, each with their
+ * own range of sizes and lifetimes (in operations).
+ */
+
+struct bench_kind_s
+{
+  const char *name;
+  int weight;                      /* Share of the allocations, in percent */
+  int minsize;
+  int maxsize;
+  int minlife;
+  int maxlife;
+};
+
+struct bench_stats_s
+{
+  uint32_t count;
+  uint32_t total;
+  uint32_t max;
+  uint32_t buckets[BENCH_NBUCKETS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct bench_kind_s g_kinds[] =
+{
+  /* Greybus messages:  small and short-lived */
+
+  { "message", 50,   16,   300,    1,    16 },
+
+  /* Network and I/O buffers */
+
+  { "buffer",  25,   64,  1600,    8,   256 },
+
+  /* Long-lived objects:  connections, handles, lists... */
+
+  { "object",  20,   24,   512,  256,  8192 },
+
+  /* Large buffers and stacks, rarely reallocated */
+
+  { "large",    5, 2048, 16384, 1024, 16384 },
+};
+
+#define BENCH_NKINDS (sizeof(g_kinds) / sizeof(g_kinds[0]))
+
+static FAR void *g_slots[BENCH_NSLOTS];
+static uint32_t g_expiry[BENCH_NSLOTS];
+static struct bench_stats_s g_malloc;
+static struct bench_stats_s g_free;
+static uint32_t g_failures;
+static uint32_t g_frag_total;
+static uint32_t g_frag_max;
+static uint32_t g_frag_samples;
+static uint32_t g_seed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t bench_usec(void)
+{
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+  return hrt_getusec();
+#else
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+/* A private generator, so that every run replays the same trace */
+
+static uint32_t bench_rand(uint32_t range)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return (g_seed >> 8) % range;
+}
+
+static void bench_record(FAR struct bench_stats_s *stats, uint32_t usec)
+{
+  int bucket = 0;
+
+  while (bucket < BENCH_NBUCKETS - 1 && (usec >> bucket) != 0)
+    {
+      bucket++;
+    }
+
+  stats->buckets[bucket]++;
+  stats->count++;
+  stats->total += usec;
+  if (usec > stats->max)
+    {
+      stats->max = usec;
+    }
+}
+
+static void bench_malloc(int slot, size_t size)
+{
+  uint32_t start;
+
+  start = bench_usec();
+  g_slots[slot] = malloc(size);
+  bench_record(&g_malloc, bench_usec() - start);
+
+  if (g_slots[slot])
+    {
+      /* Touch the memory, as a real user would */
+
+      memset(g_slots[slot], slot, size < 64 ? size : 64);
+    }
+  else
+    {
+      g_failures++;
+    }
+}
+
+static void bench_free(int slot)
+{
+  uint32_t start;
+
+  if (g_slots[slot])
+    {
+      start = bench_usec();
+      free(g_slots[slot]);
+      bench_record(&g_free, bench_usec() - start);
+
+      g_slots[slot] = NULL;
+    }
+}
+
+static void bench_sample(void)
+{
+  struct mallinfo info;
+  uint32_t frag;
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+  info = mallinfo();
+#else
+  (void)mallinfo(&info);
+#endif
+
+  /* Fragmentation is the share of the free memory that is not in the
+   * largest free chunk.
+   */
+
+  if (info.fordblks > 0)
+    {
+      frag = 100 - (uint32_t)((uint64_t)info.mxordblk * 100 / info.fordblks);
+      g_frag_total += frag;
+      g_frag_samples++;
+      if (frag > g_frag_max)
+        {
+          g_frag_max = frag;
+        }
+    }
+}
+
+/* Replay the synthetic trace:  at each operation, the expired allocations
+ * are freed and a new one is made.
+ */
+
+static void bench_synthetic(void)
+{
+  FAR const struct bench_kind_s *kind;
+  uint32_t op;
+  int weight;
+  int slot;
+  int i;
+
+  for (op = 0; op < BENCH_NOPS; op++)
+    {
+      for (i = 0; i < BENCH_NSLOTS; i++)
+        {
+          if (g_slots[i] && g_expiry[i] <= op)
+            {
+              bench_free(i);
+            }
+        }
+
+      /* Pick a kind of allocation, then a free slot for it.  If there are
+       * none left, a random allocation is freed early.
+       */
+
+      weight = bench_rand(100);
+      for (kind = g_kinds; weight >= kind->weight; kind++)
+        {
+          weight -= kind->weight;
+        }
+
+      slot = bench_rand(BENCH_NSLOTS);
+      for (i = 0; i < BENCH_NSLOTS && g_slots[slot]; i++)
+        {
+          slot = (slot + 1) % BENCH_NSLOTS;
+        }
+
+      bench_free(slot);
+      bench_malloc(slot, kind->minsize +
+                   bench_rand(kind->maxsize - kind->minsize + 1));
+      g_expiry[slot] = op + kind->minlife +
+                       bench_rand(kind->maxlife - kind->minlife + 1);
+
+      if (op % BENCH_SAMPLE == 0)
+        {
+          bench_sample();
+        }
+    }
+}
+
+/* Replay a recorded trace.  Each line is either "a <slot> <size>" to
+ * allocate or "f <slot>" to free.
+ */
+
+static int bench_file(FAR const char *path)
+{
+  char line[64];
+  uint32_t op = 0;
+  FILE *stream;
+  char cmd;
+  int slot;
+  int size;
+  int n;
+
+  stream = fopen(path, "r");
+  if (!stream)
+    {
+      printf("mm bench: cannot open %s\n", path);
+      return EXIT_FAILURE;
+    }
+
+  while (fgets(line, sizeof(line), stream))
+    {
+      n = sscanf(line, "%c %d %d", &cmd, &slot, &size);
+      if (n < 2 || slot < 0 || slot >= BENCH_NSLOTS)
+        {
+          continue;
+        }
+
+      bench_free(slot);
+      if (cmd == 'a' && n == 3)
+        {
+          bench_malloc(slot, size);
+        }
+
+      if (++op % BENCH_SAMPLE == 0)
+        {
+          bench_sample();
+        }
+    }
+
+  fclose(stream);
+  return EXIT_SUCCESS;
+}
+
+static void bench_show(FAR const char *name,
+                       FAR const struct bench_stats_s *stats)
+{
+  uint32_t sum = 0;
+  uint32_t p50 = 0;
+  uint32_t p99 = 0;
+  int bucket;
+
+  if (stats->count == 0)
+    {
+      return;
+    }
+
+  /* Percentiles are given as the upper bound of their bucket */
+
+  for (bucket = 0; bucket < BENCH_NBUCKETS; bucket++)
+    {
+      sum += stats->buckets[bucket];
+      if (p50 == 0 && sum * 2 >= stats->count)
+        {
+          p50 = bucket < BENCH_NBUCKETS - 1 ? 1 << bucket : stats->max + 1;
+        }
+
+      if (p99 == 0 && sum * 100 >= stats->count * 99)
+        {
+          p99 = bucket < BENCH_NBUCKETS - 1 ? 1 << bucket : stats->max + 1;
+        }
+    }
+
+  printf("  %-6s %7lu ops, mean %lu.%02lu us, p50 <%lu us, p99 <%lu us, "
+         "max %lu us\n", name, (unsigned long)stats->count,
+         (unsigned long)(stats->total / stats->count),
+         (unsigned long)(stats->total * 100 / stats->count % 100),
+         (unsigned long)p50, (unsigned long)p99, (unsigned long)stats->max);
+
+  printf("        ");
+  for (bucket = 0; bucket < BENCH_NBUCKETS; bucket++)
+    {
+      printf(" %s%d:%lu", bucket == BENCH_NBUCKETS - 1 ? ">=" : "<",
+             bucket == BENCH_NBUCKETS - 1 ? 1 << (bucket - 1) : 1 << bucket,
+             (unsigned long)stats->buckets[bucket]);
+    }
+
+  printf("\n");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_bench
+ *
+ * Description:
+ *   Replay an allocation trace, the built-in synthetic one or one read
+ *   from a file, and report the latency distribution of malloc and free
+ *   and the fragmentation of the heap.
+ *
+ ****************************************************************************/
+
+int mm_bench(FAR const char *trace)
+{
+  int ret = EXIT_SUCCESS;
+  int i;
+
+  memset(&g_malloc, 0, sizeof(struct bench_stats_s));
+  memset(&g_free, 0, sizeof(struct bench_stats_s));
+  g_failures     = 0;
+  g_frag_total   = 0;
+  g_frag_max     = 0;
+  g_frag_samples = 0;
+  g_seed         = 1;
+
+  printf("mm bench: replaying %s trace\n", trace ? trace : "synthetic");
+
+  if (trace)
+    {
+      ret = bench_file(trace);
+    }
+  else
+    {
+      bench_synthetic();
+    }
+
+  bench_sample();
+  for (i = 0; i < BENCH_NSLOTS; i++)
+    {
+      bench_free(i);
+    }
+
+  bench_show("malloc", &g_malloc);
+  bench_show("free", &g_free);
+
+  if (g_frag_samples > 0)
+    {
+      printf("  fragmentation: mean %lu%%, max %lu%%, %lu failed allocations\n",
+             (unsigned long)(g_frag_total / g_frag_samples),
+             (unsigned long)g_frag_max, (unsigned long)g_failures);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_EXAMPLES_MM_BENCH */
@@ -273,6 +273,14 @@ static void do_frees(void **mem, const int *size, const int *seq, int n)
     }
 }
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_EXAMPLES_MM_BENCH
+int mm_bench(FAR const char *trace);
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -311,5 +319,14 @@ int mm_main(int argc, char *argv[])
   do_frees(allocs, alloc_sizes, random1, NTEST_ALLOCS);
 
   printf("TEST COMPLETE\n");
+
+#ifdef CONFIG_EXAMPLES_MM_BENCH
+  /* Then run the benchmark, on the trace given on the command line if
+   * any.
+   */
+
+  return mm_bench(argc > 1 ? argv[1] : NULL);
+#else
   return 0;
+#endif
 }
@@ -53,8 +53,10 @@
 
 int main(int argc, char **argv, char **envp)
 {
-#ifdef CONFIG_EXAMPLES_NETTEST_SERVER
+#if defined(CONFIG_EXAMPLES_NETTEST_SERVER)
   send_client();
+#elif defined(CONFIG_EXAMPLES_NETTEST_CONNS)
+  conns_server();
 #else
   recv_server();
 #endif
@@ -105,8 +105,14 @@ int nettest_main(int argc, char *argv[])
   addr.s_addr = HTONL(CONFIG_EXAMPLES_NETTEST_NETMASK);
   netlib_setnetmask("eth0", &addr);
 
-#ifdef CONFIG_EXAMPLES_NETTEST_SERVER
+#ifdef CONFIG_EXAMPLES_NETTEST_CHKSUM
+  chksum_test();
+#endif
+
+#if defined(CONFIG_EXAMPLES_NETTEST_SERVER)
   recv_server();
+#elif defined(CONFIG_EXAMPLES_NETTEST_CONNS)
+  conns_client();
 #else
   send_client();
 #endif
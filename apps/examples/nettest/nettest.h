@@ -93,5 +93,8 @@
 
 extern void send_client(void);
 extern void recv_server(void);
+extern void conns_client(void);
+extern void conns_server(void);
+extern void chksum_test(void);
 
 #endif /* __EXAMPLES_NETTEST_H */
@@ -0,0 +1,193 @@
+/****************************************************************************
+ * examples/nettest/nettest_chksum.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <arpa/inet.h>
+#include <nuttx/net/netdev.h>
+
+#include "nettest.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+/* net_chksum() is checked against the reference implementation over
+ * CHKSUM_NCHECKS random buffers of up to CHKSUM_BUFSIZE bytes, at random
+ * alignments, then both are timed over CHKSUM_NLOOPS full-size segments.
+ */
+
+#define CHKSUM_BUFSIZE  1600
+#define CHKSUM_NCHECKS  10000
+#define CHKSUM_SEGSIZE  1460
+#define CHKSUM_NLOOPS   2000
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_chksum_buffer[(CHKSUM_BUFSIZE + 4) / 4];
+
+/* Keeps the compiler from dropping the timed calls */
+
+static volatile uint16_t g_chksum_result;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static unsigned long chksum_usec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* The byte at a time sum that net_chksum() used before */
+
+static uint16_t chksum_reference(FAR const uint8_t *data, uint16_t len)
+{
+  FAR const uint8_t *last = data + len - 1;
+  uint16_t sum = 0;
+  uint16_t t;
+
+  for (; data < last; data += 2)
+    {
+      t = (data[0] << 8) + data[1];
+      sum += t;
+      if (sum < t)
+        {
+          sum++;
+        }
+    }
+
+  if (data == last)
+    {
+      t = data[0] << 8;
+      sum += t;
+      if (sum < t)
+        {
+          sum++;
+        }
+    }
+
+  return htons(sum);
+}
+
+static void chksum_fill(FAR uint8_t *data, int len, int pattern)
+{
+  int i;
+
+  /* All zeroes and all ones check the representation of zero */
+
+  for (i = 0; i < len; i++)
+    {
+      data[i] = pattern == 0 ? 0x00 : pattern == 1 ? 0xff : rand();
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void chksum_test(void)
+{
+  FAR uint8_t *buffer = (FAR uint8_t *)g_chksum_buffer;
+  unsigned long start;
+  unsigned long tref;
+  unsigned long tnew;
+  uint16_t expected;
+  uint16_t sum;
+  int nerrors = 0;
+  int offset;
+  int len;
+  int i;
+
+  for (i = 0; i < CHKSUM_NCHECKS; i++)
+    {
+      offset = rand() % 4;
+      len    = rand() % (CHKSUM_BUFSIZE + 1);
+      chksum_fill(buffer, CHKSUM_BUFSIZE + 4, rand() % 4);
+
+      expected = chksum_reference(&buffer[offset], len);
+      sum      = net_chksum((FAR uint16_t *)&buffer[offset], len);
+      if (sum != expected)
+        {
+          if (nerrors++ < 8)
+            {
+              message("chksum: ERROR offset %d len %d: %04x expected %04x\n",
+                      offset, len, sum, expected);
+            }
+        }
+    }
+
+  message("chksum: %d/%d buffers checked OK\n",
+          CHKSUM_NCHECKS - nerrors, CHKSUM_NCHECKS);
+
+  /* Then time both over aligned and odd segments */
+
+  chksum_fill(buffer, CHKSUM_BUFSIZE + 4, 2);
+
+  start = chksum_usec();
+  for (i = 0; i < CHKSUM_NLOOPS; i++)
+    {
+      g_chksum_result = chksum_reference(&buffer[i & 1], CHKSUM_SEGSIZE);
+    }
+
+  tref  = chksum_usec() - start;
+  start = chksum_usec();
+  for (i = 0; i < CHKSUM_NLOOPS; i++)
+    {
+      g_chksum_result = net_chksum((FAR uint16_t *)&buffer[i & 1],
+                                   CHKSUM_SEGSIZE);
+    }
+
+  tnew = chksum_usec() - start;
+
+  /* Report in nanoseconds per segment */
+
+  message("chksum: %d bytes: reference %lu ns, net_chksum %lu ns\n",
+          CHKSUM_SEGSIZE,
+          tref * 1000 / CHKSUM_NLOOPS, tnew * 1000 / CHKSUM_NLOOPS);
+}
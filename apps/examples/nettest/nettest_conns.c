@@ -0,0 +1,279 @@
+/****************************************************************************
+ * examples/nettest/nettest_conns.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+
+#include <arpa/inet.h>
+
+#include "nettest.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define CONNS_NCONNS   CONFIG_EXAMPLES_NETTEST_NCONNS
+
+/* Each round sends one short message on each connection in turn and waits
+ * for it to be echoed back, so that every segment received by the target
+ * has to be matched with one of CONNS_NCONNS connections.
+ */
+
+#define CONNS_ROUNDS   16
+#define CONNS_MSGSIZE  64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_sockfd[CONNS_NCONNS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifndef NETTEST_HOST
+static unsigned long conns_msec(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+#endif
+
+static void conns_close(int nconns)
+{
+  int i;
+
+  for (i = 0; i < nconns; i++)
+    {
+      close(g_sockfd[i]);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifndef NETTEST_HOST
+/****************************************************************************
+ * Name: conns_client
+ *
+ * Description:
+ *   Open CONNS_NCONNS connections to the server and time the round trips
+ *   of short messages over all of them.
+ *
+ ****************************************************************************/
+
+void conns_client(void)
+{
+  struct sockaddr_in myaddr;
+  char buffer[CONNS_MSGSIZE];
+  unsigned long elapsed;
+  int nconns;
+  int nbytes;
+  int total;
+  int round;
+  int i;
+
+  myaddr.sin_family      = AF_INET;
+  myaddr.sin_port        = HTONS(PORTNO);
+  myaddr.sin_addr.s_addr = HTONL(CONFIG_EXAMPLES_NETTEST_CLIENTIP);
+
+  message("conns: Connecting %d times...\n", CONNS_NCONNS);
+  for (nconns = 0; nconns < CONNS_NCONNS; nconns++)
+    {
+      g_sockfd[nconns] = socket(PF_INET, SOCK_STREAM, 0);
+      if (g_sockfd[nconns] < 0)
+        {
+          message("conns: socket failure %d after %d connections\n",
+                  errno, nconns);
+          goto errout;
+        }
+
+      if (connect(g_sockfd[nconns], (struct sockaddr*)&myaddr,
+                  sizeof(struct sockaddr_in)) < 0)
+        {
+          message("conns: connect failure %d after %d connections\n",
+                  errno, nconns);
+          close(g_sockfd[nconns]);
+          goto errout;
+        }
+    }
+
+  memset(buffer, 'c', CONNS_MSGSIZE);
+  elapsed = conns_msec();
+
+  for (round = 0; round < CONNS_ROUNDS; round++)
+    {
+      for (i = 0; i < nconns; i++)
+        {
+          if (send(g_sockfd[i], buffer, CONNS_MSGSIZE, 0) != CONNS_MSGSIZE)
+            {
+              message("conns: send failed: %d\n", errno);
+              goto errout;
+            }
+
+          for (total = 0; total < CONNS_MSGSIZE; total += nbytes)
+            {
+              nbytes = recv(g_sockfd[i], &buffer[total],
+                            CONNS_MSGSIZE - total, 0);
+              if (nbytes <= 0)
+                {
+                  message("conns: recv failed: %d\n", errno);
+                  goto errout;
+                }
+            }
+        }
+    }
+
+  elapsed = conns_msec() - elapsed;
+  message("conns: %d connections, %d round trips in %lu ms, %lu us each\n",
+          nconns, nconns * CONNS_ROUNDS, elapsed,
+          elapsed * 1000 / (nconns * CONNS_ROUNDS));
+
+  conns_close(nconns);
+  return;
+
+errout:
+  conns_close(nconns);
+  exit(1);
+}
+#endif /* !NETTEST_HOST */
+
+#ifdef NETTEST_HOST
+/****************************************************************************
+ * Name: conns_server
+ *
+ * Description:
+ *   Accept CONNS_NCONNS connections and echo whatever is received on any
+ *   of them until they are all closed.
+ *
+ ****************************************************************************/
+
+void conns_server(void)
+{
+  static struct pollfd fds[CONNS_NCONNS];
+  struct sockaddr_in myaddr;
+  char buffer[CONNS_MSGSIZE];
+  int listensd;
+  int nconns;
+  int nopen;
+  int optval;
+  int nbytes;
+  int i;
+
+  listensd = socket(PF_INET, SOCK_STREAM, 0);
+  if (listensd < 0)
+    {
+      message("conns: socket failure: %d\n", errno);
+      exit(1);
+    }
+
+  optval = 1;
+  (void)setsockopt(listensd, SOL_SOCKET, SO_REUSEADDR, (void*)&optval,
+                   sizeof(int));
+
+  myaddr.sin_family      = AF_INET;
+  myaddr.sin_port        = HTONS(PORTNO);
+  myaddr.sin_addr.s_addr = INADDR_ANY;
+
+  if (bind(listensd, (struct sockaddr*)&myaddr,
+           sizeof(struct sockaddr_in)) < 0 ||
+      listen(listensd, CONNS_NCONNS) < 0)
+    {
+      message("conns: bind/listen failure: %d\n", errno);
+      close(listensd);
+      exit(1);
+    }
+
+  message("conns: Accepting %d connections...\n", CONNS_NCONNS);
+  for (nconns = 0; nconns < CONNS_NCONNS; nconns++)
+    {
+      g_sockfd[nconns] = accept(listensd, NULL, NULL);
+      if (g_sockfd[nconns] < 0)
+        {
+          message("conns: accept failure: %d\n", errno);
+          break;
+        }
+
+      fds[nconns].fd     = g_sockfd[nconns];
+      fds[nconns].events = POLLIN;
+    }
+
+  close(listensd);
+  message("conns: %d connections, echoing...\n", nconns);
+
+  for (nopen = nconns; nopen > 0; )
+    {
+      if (poll(fds, nconns, -1) < 0)
+        {
+          message("conns: poll failure: %d\n", errno);
+          break;
+        }
+
+      for (i = 0; i < nconns; i++)
+        {
+          if (fds[i].fd < 0 || fds[i].revents == 0)
+            {
+              continue;
+            }
+
+          nbytes = recv(fds[i].fd, buffer, CONNS_MSGSIZE, 0);
+          if (nbytes <= 0 || send(fds[i].fd, buffer, nbytes, 0) != nbytes)
+            {
+              /* Closed by the client, stop polling it */
+
+              fds[i].fd = -1;
+              nopen--;
+            }
+        }
+    }
+
+  conns_close(nconns);
+}
+#endif /* NETTEST_HOST */
@@ -41,9 +41,11 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <time.h>
 #include <errno.h>
 
 #include <arpa/inet.h>
@@ -65,7 +67,12 @@ void recv_server(void)
   int acceptsd;
   socklen_t addrlen;
   int nbytesread;
-#ifndef CONFIG_EXAMPLES_NETTEST_PERFORMANCE
+#ifdef CONFIG_EXAMPLES_NETTEST_PERFORMANCE
+  struct timespec start;
+  struct timespec now;
+  unsigned long totalbytesread;
+  unsigned long msec;
+#else
   int totalbytesread;
   int nbytessent;
   int ch;
@@ -147,7 +154,10 @@ void recv_server(void)
 #endif
 
 #ifdef CONFIG_EXAMPLES_NETTEST_PERFORMANCE
-  /* Then receive data forever */
+  /* Then receive data forever, reporting the throughput every second */
+
+  totalbytesread = 0;
+  (void)clock_gettime(CLOCK_REALTIME, &start);
 
   for (;;)
     {
@@ -162,7 +172,20 @@ void recv_server(void)
           message("server: The client broke the connection\n");
           goto errout_with_acceptsd;
         }
-      message("Received %d bytes\n", nbytesread);
+
+      totalbytesread += nbytesread;
+      (void)clock_gettime(CLOCK_REALTIME, &now);
+      msec = (now.tv_sec - start.tv_sec) * 1000 +
+             (now.tv_nsec - start.tv_nsec) / 1000000;
+
+      if (msec >= 1000)
+        {
+          message("server: Received %lu bytes in %lu ms: %lu bytes/s\n",
+                  totalbytesread, msec,
+                  (unsigned long)((uint64_t)totalbytesread * 1000 / msec));
+          totalbytesread = 0;
+          start = now;
+        }
     }
 #else
   /* Receive canned message */
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * examples/ostest/granbench.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/mm/gran.h>
+
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+#  include <nuttx/hires_tmr.h>
+#endif
+
+#include "ostest.h"
+
+#ifdef CONFIG_EXAMPLES_OSTEST_GRANBENCH
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define GRANBENCH_NGRANULES  CONFIG_EXAMPLES_OSTEST_GRANBENCH_NGRANULES
+
+/* The heap is filled with blocks of 1 to GRANBENCH_MAXFILL granules, some
+ * of which are then freed to fragment it (see granbench_fill()).  Each of
+ * the sizes in g_gransizes is then allocated and freed GRANBENCH_ROUNDS
+ * times.
+ */
+
+#define GRANBENCH_LOG2GRAN   6
+#define GRANBENCH_MAXFILL    4
+#define GRANBENCH_ROUNDS     64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_gransizes[] =
+{
+  1, 4, 16, 64
+};
+
+static const uint8_t g_granfills[] =
+{
+  0, 25, 50, 75, 90
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t granbench_usec(void)
+{
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+  return hrt_getusec();
+#else
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+/* Fill the heap to a percentage of its granules, fragmenting it.  Returns
+ * the number of blocks allocated, the ones freed again being set to NULL.
+ */
+
+static int granbench_fill(GRAN_HANDLE handle, FAR void **blocks,
+                          FAR uint8_t *sizes, int fill)
+{
+  int target = GRANBENCH_NGRANULES * fill / 100;
+  int limit = target + (GRANBENCH_NGRANULES - target) / 2;
+  int used = 0;
+  int nblocks = 0;
+  int i;
+
+  /* Allocate half of the free space beyond the target, then free every
+   * other block from the start of the heap down to the target.  This
+   * leaves small holes ahead of the free space at the end of the heap.
+   */
+
+  while (used < limit)
+    {
+      sizes[nblocks]  = 1 + rand() % GRANBENCH_MAXFILL;
+      blocks[nblocks] = gran_alloc(handle,
+                                   sizes[nblocks] << GRANBENCH_LOG2GRAN);
+      if (blocks[nblocks] == NULL)
+        {
+          break;
+        }
+
+      used += sizes[nblocks++];
+    }
+
+  for (i = 0; i < nblocks && used > target; i += 2)
+    {
+      gran_free(handle, blocks[i], sizes[i] << GRANBENCH_LOG2GRAN);
+      blocks[i] = NULL;
+      used -= sizes[i];
+    }
+
+  return nblocks;
+}
+
+static void granbench_empty(GRAN_HANDLE handle, FAR void **blocks,
+                            FAR uint8_t *sizes, int nblocks)
+{
+  int i;
+
+  for (i = 0; i < nblocks; i++)
+    {
+      if (blocks[i] != NULL)
+        {
+          gran_free(handle, blocks[i], sizes[i] << GRANBENCH_LOG2GRAN);
+          blocks[i] = NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: granbench_test
+ *
+ * Description:
+ *   Measure the latency of granule allocations of various sizes as the
+ *   heap gets filled and fragmented.
+ *
+ ****************************************************************************/
+
+void granbench_test(void)
+{
+  FAR uint8_t *heap;
+  FAR uint8_t *sizes;
+  FAR void **blocks;
+  FAR void *mem;
+  GRAN_HANDLE handle;
+  uint32_t elapsed;
+  uint32_t start;
+  int nblocks;
+  int nfail;
+  int fill;
+  int size;
+  int i;
+
+  heap   = (FAR uint8_t *)malloc(GRANBENCH_NGRANULES << GRANBENCH_LOG2GRAN);
+  blocks = (FAR void **)malloc(GRANBENCH_NGRANULES * sizeof(FAR void *));
+  sizes  = (FAR uint8_t *)malloc(GRANBENCH_NGRANULES);
+  if (heap == NULL || blocks == NULL || sizes == NULL)
+    {
+      printf("granbench: ERROR failed to allocate the heap\n");
+      goto errout;
+    }
+
+  handle = gran_initialize(heap, GRANBENCH_NGRANULES << GRANBENCH_LOG2GRAN,
+                           GRANBENCH_LOG2GRAN, GRANBENCH_LOG2GRAN);
+  if (handle == NULL)
+    {
+      printf("granbench: ERROR gran_initialize failed\n");
+      goto errout;
+    }
+
+  for (fill = 0; fill < sizeof(g_granfills); fill++)
+    {
+      nblocks = granbench_fill(handle, blocks, sizes, g_granfills[fill]);
+
+      printf("granbench: %2d%% full:", g_granfills[fill]);
+      for (size = 0; size < sizeof(g_gransizes) / sizeof(g_gransizes[0]);
+           size++)
+        {
+          nfail   = 0;
+          elapsed = 0;
+
+          /* Each allocation is freed right away, so that all of them
+           * search the same heap.
+           */
+
+          for (i = 0; i < GRANBENCH_ROUNDS; i++)
+            {
+              start    = granbench_usec();
+              mem      = gran_alloc(handle,
+                                    g_gransizes[size] << GRANBENCH_LOG2GRAN);
+              elapsed += granbench_usec() - start;
+
+              if (mem == NULL)
+                {
+                  nfail++;
+                  continue;
+                }
+
+              gran_free(handle, mem, g_gransizes[size] << GRANBENCH_LOG2GRAN);
+            }
+
+          /* Report tenths of microseconds per allocation */
+
+          elapsed = elapsed * 10 / GRANBENCH_ROUNDS;
+          printf(" %d: %lu.%lu us", g_gransizes[size],
+                 (unsigned long)elapsed / 10, (unsigned long)elapsed % 10);
+
+          if (nfail > 0)
+            {
+              printf(" (%d failed)", nfail);
+            }
+        }
+
+      printf("\n");
+      granbench_empty(handle, blocks, sizes, nblocks);
+    }
+
+  gran_release(handle);
+
+errout:
+  free(sizes);
+  free(blocks);
+  free(heap);
+}
+
+#endif /* CONFIG_EXAMPLES_OSTEST_GRANBENCH */
@@ -0,0 +1,214 @@
+/****************************************************************************
+ * examples/ostest/mutexbench.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+#  include <nuttx/hires_tmr.h>
+#endif
+
+#include "ostest.h"
+
+#ifdef CONFIG_EXAMPLES_OSTEST_MUTEXBENCH
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define MUTEXBENCH_LOOPS     CONFIG_EXAMPLES_OSTEST_MUTEXBENCH_LOOPS
+#define MUTEXBENCH_STACKSIZE 1024
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_mutex;
+static sem_t g_gosem;
+static volatile bool g_exit;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t mutexbench_usec(void)
+{
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+  return hrt_getusec();
+#else
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+static int mutexbench_start(FAR pthread_t *thread, int priority,
+                            pthread_startroutine_t entry)
+{
+  struct sched_param sparam;
+  pthread_attr_t attr;
+  int status;
+
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, MUTEXBENCH_STACKSIZE);
+
+  sparam.sched_priority = priority;
+  (void)pthread_attr_setschedparam(&attr, &sparam);
+
+  status = pthread_create(thread, &attr, entry, NULL);
+  if (status != 0)
+    {
+      printf("mutexbench: pthread_create failed, status=%d\n", status);
+    }
+
+  return status;
+}
+
+/* Runs above the measuring thread:  each time it is let go, it preempts
+ * the measuring thread and blocks on the mutex that thread holds, boosting
+ * its priority until the mutex is handed over.
+ */
+
+static FAR void *mutexbench_contender(FAR void *arg)
+{
+  while (!g_exit)
+    {
+      (void)sem_wait(&g_gosem);
+      (void)pthread_mutex_lock(&g_mutex);
+      (void)pthread_mutex_unlock(&g_mutex);
+    }
+
+  return NULL;
+}
+
+static FAR void *mutexbench_main(FAR void *arg)
+{
+  pthread_t contender;
+  uint32_t uncontended;
+  uint32_t contended;
+  uint32_t start;
+  int i;
+
+  /* No other thread ever wants the mutex */
+
+  start = mutexbench_usec();
+  for (i = 0; i < MUTEXBENCH_LOOPS; i++)
+    {
+      (void)pthread_mutex_lock(&g_mutex);
+      (void)pthread_mutex_unlock(&g_mutex);
+    }
+
+  uncontended = mutexbench_usec() - start;
+
+  /* A higher priority thread blocks on the mutex every time it is held */
+
+  if (mutexbench_start(&contender, sched_get_priority_max(SCHED_FIFO) - 1,
+                       mutexbench_contender) != 0)
+    {
+      return NULL;
+    }
+
+  start = mutexbench_usec();
+  for (i = 0; i < MUTEXBENCH_LOOPS; i++)
+    {
+      (void)pthread_mutex_lock(&g_mutex);
+      sem_post(&g_gosem);
+      (void)pthread_mutex_unlock(&g_mutex);
+    }
+
+  contended = mutexbench_usec() - start;
+
+  g_exit = true;
+  sem_post(&g_gosem);
+  (void)pthread_join(contender, NULL);
+
+  /* Report tenths of microseconds per lock and unlock pair.  The contended
+   * pairs include the wakeup of the contender and the two context switches.
+   */
+
+  uncontended = uncontended * 10 / MUTEXBENCH_LOOPS;
+  contended   = contended * 10 / MUTEXBENCH_LOOPS;
+
+  printf("mutexbench: uncontended %lu.%lu us, contended %lu.%lu us\n",
+         (unsigned long)uncontended / 10, (unsigned long)uncontended % 10,
+         (unsigned long)contended / 10, (unsigned long)contended % 10);
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mutexbench_test
+ *
+ * Description:
+ *   Measure the cost of locking and unlocking a mutex, with and without a
+ *   higher priority thread waiting for it.
+ *
+ ****************************************************************************/
+
+void mutexbench_test(void)
+{
+  pthread_t thread;
+
+  g_exit = false;
+
+  pthread_mutex_init(&g_mutex, NULL);
+  sem_init(&g_gosem, 0, 0);
+
+  if (mutexbench_start(&thread, sched_get_priority_max(SCHED_FIFO) - 2,
+                       mutexbench_main) == 0)
+    {
+      (void)pthread_join(thread, NULL);
+    }
+
+  sem_destroy(&g_gosem);
+  pthread_mutex_destroy(&g_mutex);
+}
+
+#endif /* CONFIG_EXAMPLES_OSTEST_MUTEXBENCH */
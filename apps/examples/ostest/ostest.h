@@ -169,6 +169,22 @@ void timer_test(void);
 
 void rr_test(void);
 
+/* wdstress.c ***************************************************************/
+
+void wdstress_test(void);
+
+/* schedlat.c ***************************************************************/
+
+void schedlat_test(void);
+
+/* mutexbench.c *************************************************************/
+
+void mutexbench_test(void);
+
+/* granbench.c **************************************************************/
+
+void granbench_test(void);
+
 /* barrier.c ****************************************************************/
 
 void barrier_test(void);
@@ -444,6 +444,38 @@ static int user_main(int argc, char *argv[])
       check_test_memory_usage();
 #endif
 
+#ifdef CONFIG_EXAMPLES_OSTEST_WDSTRESS
+      /* Stress the watchdog timers */
+
+      printf("\nuser_main: watchdog stress benchmark\n");
+      wdstress_test();
+      check_test_memory_usage();
+#endif
+
+#ifdef CONFIG_EXAMPLES_OSTEST_SCHEDLAT
+      /* Measure scheduler latencies */
+
+      printf("\nuser_main: scheduler latency benchmark\n");
+      schedlat_test();
+      check_test_memory_usage();
+#endif
+
+#ifdef CONFIG_EXAMPLES_OSTEST_MUTEXBENCH
+      /* Measure mutex latencies */
+
+      printf("\nuser_main: mutex benchmark\n");
+      mutexbench_test();
+      check_test_memory_usage();
+#endif
+
+#ifdef CONFIG_EXAMPLES_OSTEST_GRANBENCH
+      /* Measure granule allocator latencies */
+
+      printf("\nuser_main: granule allocator benchmark\n");
+      granbench_test();
+      check_test_memory_usage();
+#endif
+
 #ifndef CONFIG_DISABLE_PTHREAD
       /* Verify pthread barriers */
 
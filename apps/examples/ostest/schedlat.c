@@ -0,0 +1,305 @@
+/****************************************************************************
+ * examples/ostest/schedlat.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+#  include <nuttx/hires_tmr.h>
+#endif
+
+#include "ostest.h"
+
+#ifdef CONFIG_EXAMPLES_OSTEST_SCHEDLAT
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define SCHEDLAT_MAXREADY    CONFIG_EXAMPLES_OSTEST_SCHEDLAT_MAXREADY
+#define SCHEDLAT_STACKSIZE   CONFIG_EXAMPLES_OSTEST_SCHEDLAT_STACKSIZE
+
+/* Each measurement round wakes up every waiter once and does SCHEDLAT_PINGS
+ * round trips between the measuring thread and its partner.
+ */
+
+#define SCHEDLAT_NWAITERS    8
+#define SCHEDLAT_ROUNDS      16
+#define SCHEDLAT_PINGS       64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_t g_fillers[SCHEDLAT_MAXREADY];
+static pthread_t g_waiters[SCHEDLAT_NWAITERS];
+static sem_t g_wakesem[SCHEDLAT_NWAITERS];
+static sem_t g_pingsem;
+static sem_t g_pongsem;
+static volatile bool g_release;
+static volatile bool g_exit;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t schedlat_usec(void)
+{
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+  return hrt_getusec();
+#else
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+static int schedlat_start(FAR pthread_t *thread, int priority,
+                          pthread_startroutine_t entry, FAR void *arg)
+{
+  struct sched_param sparam;
+  pthread_attr_t attr;
+  int status;
+
+  (void)pthread_attr_init(&attr);
+  (void)pthread_attr_setstacksize(&attr, SCHEDLAT_STACKSIZE);
+
+  sparam.sched_priority = priority;
+  (void)pthread_attr_setschedparam(&attr, &sparam);
+
+  status = pthread_create(thread, &attr, entry, arg);
+  if (status != 0)
+    {
+      printf("schedlat: pthread_create failed, status=%d\n", status);
+    }
+
+  return status;
+}
+
+/* Keeps the ready-to-run list populated until released */
+
+static FAR void *schedlat_filler(FAR void *arg)
+{
+  while (!g_release);
+  return NULL;
+}
+
+/* Runs below all of the fillers, so that waking it up inserts it after
+ * every ready filler in the ready-to-run list.
+ */
+
+static FAR void *schedlat_waiter(FAR void *arg)
+{
+  FAR sem_t *sem = (FAR sem_t *)arg;
+
+  while (!g_exit)
+    {
+      (void)sem_wait(sem);
+    }
+
+  return NULL;
+}
+
+/* Runs above the measuring thread:  each ping preempts the measuring
+ * thread, each pong returns to it.
+ */
+
+static FAR void *schedlat_pong(FAR void *arg)
+{
+  while (!g_exit)
+    {
+      (void)sem_wait(&g_pingsem);
+      sem_post(&g_pongsem);
+    }
+
+  return NULL;
+}
+
+static FAR void *schedlat_main(FAR void *arg)
+{
+  pthread_t pong;
+  int prio_max = sched_get_priority_max(SCHED_FIFO);
+  int prio_min = sched_get_priority_min(SCHED_FIFO);
+  int prio_bench = prio_max - 1;
+  int prio_wait = prio_min + 1;
+  uint32_t wakeup;
+  uint32_t ping;
+  uint32_t start;
+  int nready;
+  int round;
+  int i;
+
+  /* The waiters must block on their semaphore before the fillers are
+   * started, after which they will not get to run.
+   */
+
+  for (i = 0; i < SCHEDLAT_NWAITERS; i++)
+    {
+      sem_init(&g_wakesem[i], 0, 0);
+      if (schedlat_start(&g_waiters[i], prio_wait, schedlat_waiter,
+                         &g_wakesem[i]) != 0)
+        {
+          return NULL;
+        }
+    }
+
+  if (schedlat_start(&pong, prio_bench + 1, schedlat_pong, NULL) != 0)
+    {
+      return NULL;
+    }
+
+  usleep(10000);
+
+  for (nready = 0; nready <= SCHEDLAT_MAXREADY;
+       nready += SCHEDLAT_MAXREADY / 4)
+    {
+      wakeup = 0;
+      ping   = 0;
+
+      for (round = 0; round < SCHEDLAT_ROUNDS; round++)
+        {
+          /* Fill the ready-to-run list with tasks spread over the
+           * priorities between the waiters and this thread.
+           */
+
+          g_release = false;
+          for (i = 0; i < nready; i++)
+            {
+              (void)schedlat_start(&g_fillers[i], prio_wait + 1 +
+                                   i * (prio_bench - prio_wait - 2) / nready,
+                                   schedlat_filler, NULL);
+            }
+
+          start = schedlat_usec();
+          for (i = 0; i < SCHEDLAT_NWAITERS; i++)
+            {
+              sem_post(&g_wakesem[i]);
+            }
+
+          wakeup += schedlat_usec() - start;
+
+          start = schedlat_usec();
+          for (i = 0; i < SCHEDLAT_PINGS; i++)
+            {
+              sem_post(&g_pingsem);
+              (void)sem_wait(&g_pongsem);
+            }
+
+          ping += schedlat_usec() - start;
+
+          /* Let the fillers exit, and the waiters block again */
+
+          g_release = true;
+          for (i = 0; i < nready; i++)
+            {
+              (void)pthread_join(g_fillers[i], NULL);
+            }
+
+          usleep(10000);
+        }
+
+      /* Report tenths of microseconds per wakeup and per context switch
+       * (two per round trip).
+       */
+
+      wakeup = wakeup * 10 / (SCHEDLAT_ROUNDS * SCHEDLAT_NWAITERS);
+      ping   = ping * 10 / (SCHEDLAT_ROUNDS * SCHEDLAT_PINGS * 2);
+
+      printf("schedlat: %3d ready: wakeup %lu.%lu us, switch %lu.%lu us\n",
+             nready, (unsigned long)wakeup / 10, (unsigned long)wakeup % 10,
+             (unsigned long)ping / 10, (unsigned long)ping % 10);
+    }
+
+  g_exit = true;
+
+  sem_post(&g_pingsem);
+  (void)pthread_join(pong, NULL);
+
+  for (i = 0; i < SCHEDLAT_NWAITERS; i++)
+    {
+      sem_post(&g_wakesem[i]);
+      (void)pthread_join(g_waiters[i], NULL);
+      sem_destroy(&g_wakesem[i]);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedlat_test
+ *
+ * Description:
+ *   Measure the cost of waking up a task and of a context switch as the
+ *   number of ready-to-run tasks grows.
+ *
+ ****************************************************************************/
+
+void schedlat_test(void)
+{
+  pthread_t thread;
+
+  g_release = false;
+  g_exit    = false;
+
+  sem_init(&g_pingsem, 0, 0);
+  sem_init(&g_pongsem, 0, 0);
+
+  if (schedlat_start(&thread, sched_get_priority_max(SCHED_FIFO) - 1,
+                     schedlat_main, NULL) == 0)
+    {
+      (void)pthread_join(thread, NULL);
+    }
+
+  sem_destroy(&g_pingsem);
+  sem_destroy(&g_pongsem);
+}
+
+#endif /* CONFIG_EXAMPLES_OSTEST_SCHEDLAT */
@@ -0,0 +1,223 @@
+/****************************************************************************
+ * examples/ostest/wdstress.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+#  include <nuttx/hires_tmr.h>
+#endif
+
+#include "ostest.h"
+
+#ifdef CONFIG_EXAMPLES_OSTEST_WDSTRESS
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+
+#define WDSTRESS_NWDOGS      CONFIG_EXAMPLES_OSTEST_WDSTRESS_NWDOGS
+
+/* Watchdogs are started with a delay of up to WDSTRESS_MAXDELAY ticks, then
+ * restarted WDSTRESS_RESTARTS times each, as greybus does with its request
+ * timeouts.  One in WDSTRESS_SHORT is given a short delay to check that
+ * watchdogs still expire on time under load.
+ */
+
+#define WDSTRESS_MAXDELAY    (10 * CLK_TCK)
+#define WDSTRESS_SHORTDELAY  (CLK_TCK / 10 + 1)
+#define WDSTRESS_SHORT       16
+#define WDSTRESS_RESTARTS    4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static WDOG_ID g_wdogs[WDSTRESS_NWDOGS];
+static volatile int g_nexpired;
+static volatile int g_nlate;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t wdstress_usec(void)
+{
+#ifdef CONFIG_ARCH_HAVE_HIRES_TIMER
+  return hrt_getusec();
+#else
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+static void wdstress_expiration(int argc, uint32_t deadline)
+{
+  /* Watchdogs run one tick after their delay */
+
+  if ((int32_t)(clock_systimer() - deadline) > 1)
+    {
+      g_nlate++;
+    }
+
+  g_nexpired++;
+}
+
+static uint32_t wdstress_start(int index)
+{
+  uint32_t start;
+  int delay;
+
+  if (index % WDSTRESS_SHORT == 0)
+    {
+      delay = WDSTRESS_SHORTDELAY;
+    }
+  else
+    {
+      delay = WDSTRESS_MAXDELAY / 2 + rand() % (WDSTRESS_MAXDELAY / 2);
+    }
+
+  start = wdstress_usec();
+  (void)wd_start(g_wdogs[index], delay, (wdentry_t)wdstress_expiration, 1,
+                 (uint32_t)(clock_systimer() + delay));
+  return wdstress_usec() - start;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wdstress_test
+ *
+ * Description:
+ *   Measure the cost of starting and cancelling watchdogs with thousands
+ *   of them active, and check that the short ones still expire on time.
+ *
+ ****************************************************************************/
+
+void wdstress_test(void)
+{
+  uint32_t tstart = 0;
+  uint32_t tcancel = 0;
+  uint32_t start;
+  int nshort = 0;
+  int i;
+  int j;
+
+  g_nexpired = 0;
+  g_nlate    = 0;
+
+  for (i = 0; i < WDSTRESS_NWDOGS; i++)
+    {
+      g_wdogs[i] = wd_create();
+      if (!g_wdogs[i])
+        {
+          printf("wdstress: wd_create failed after %d watchdogs\n", i);
+          goto errout;
+        }
+    }
+
+  for (i = 0; i < WDSTRESS_NWDOGS; i++)
+    {
+      tstart += wdstress_start(i);
+    }
+
+  for (j = 0; j < WDSTRESS_RESTARTS; j++)
+    {
+      for (i = 0; i < WDSTRESS_NWDOGS; i++)
+        {
+          if (i % WDSTRESS_SHORT != 0)
+            {
+              tstart += wdstress_start(i);
+            }
+        }
+    }
+
+  /* Let the short watchdogs expire */
+
+  usleep(2 * 1000000 * WDSTRESS_SHORTDELAY / CLK_TCK);
+
+  for (i = 0; i < WDSTRESS_NWDOGS; i++)
+    {
+      if (i % WDSTRESS_SHORT == 0)
+        {
+          nshort++;
+        }
+
+      start = wdstress_usec();
+      (void)wd_cancel(g_wdogs[i]);
+      tcancel += wdstress_usec() - start;
+    }
+
+  /* Report tenths of microseconds per call */
+
+  tstart  = tstart * 10 / (WDSTRESS_NWDOGS * (WDSTRESS_RESTARTS + 1) -
+                           WDSTRESS_RESTARTS * nshort);
+  tcancel = tcancel * 10 / WDSTRESS_NWDOGS;
+
+  printf("wdstress: %d watchdogs: start %lu.%lu us, cancel %lu.%lu us\n",
+         WDSTRESS_NWDOGS,
+         (unsigned long)tstart / 10, (unsigned long)tstart % 10,
+         (unsigned long)tcancel / 10, (unsigned long)tcancel % 10);
+
+  if (g_nexpired != nshort || g_nlate != 0)
+    {
+      printf("wdstress: ERROR %d/%d watchdogs expired, %d late\n",
+             g_nexpired, nshort, g_nlate);
+    }
+
+errout:
+  for (i = 0; i < WDSTRESS_NWDOGS && g_wdogs[i]; i++)
+    {
+      (void)wd_delete(g_wdogs[i]);
+      g_wdogs[i] = NULL;
+    }
+}
+
+#endif /* CONFIG_EXAMPLES_OSTEST_WDSTRESS */
@@ -45,5 +45,19 @@ uint32_t atomic_add(atomic_t *atomic, int n);
 uint32_t atomic_inc(atomic_t *atomic);
 uint32_t atomic_dec(atomic_t *atomic);
 
+/*
+ * Lock-free stack (LIFO) of nodes whose first word points to the next node,
+ * safe against the interrupt handlers pushing and popping the same stack.
+ */
+
+void atomic_push(void *volatile *head, void *node);
+void *atomic_pop(void *volatile *head);
+
+/*
+ * Store newval to *ptr if it still holds oldval, return 1 if it did.
+ */
+
+int atomic_cmpxchg16(volatile int16_t *ptr, int16_t oldval, int16_t newval);
+
 #endif /* __ATOMIC_H__ */
 
@@ -209,10 +209,12 @@ int up_buttonevent(int x, int y, int buttons);
 #if defined(CONFIG_NET) && !defined(__CYGWIN__)
 void tapdev_init(void);
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen);
+unsigned int tapdev_tryread(unsigned char *buf, unsigned int buflen);
 void tapdev_send(unsigned char *buf, unsigned int buflen);
 
 #define netdev_init()           tapdev_init()
 #define netdev_read(buf,buflen) tapdev_read(buf,buflen)
+#define netdev_tryread(buf,buflen) tapdev_tryread(buf,buflen)
 #define netdev_send(buf,buflen) tapdev_send(buf,buflen)
 #endif
 
@@ -225,6 +227,7 @@ void wpcap_send(unsigned char *buf, unsigned int buflen);
 
 #define netdev_init()           wpcap_init()
 #define netdev_read(buf,buflen) wpcap_read(buf,buflen)
+#define netdev_tryread(buf,buflen) wpcap_read(buf,buflen) /* never blocks */
 #define netdev_send(buf,buflen) wpcap_send(buf,buflen)
 #endif
 
@@ -55,6 +55,7 @@
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
+#include <nuttx/net/tcp.h>
 
 #include "up_internal.h"
 
@@ -64,6 +65,22 @@
 
 #define BUF ((struct ether_header*)g_sim_dev.d_buf)
 
+/* With descriptor rings, the number of transmit and of receive buffers */
+
+#define SIM_NDESC 8
+
+/* With TCP large send, the TCP data taken in one frame, and cut into
+ * segments by sim_transmit().  All of the ring buffers are that large since
+ * devif_ring_input() swaps transmit and receive buffers.
+ */
+
+#if defined(CONFIG_NET_RINGS) && defined(CONFIG_NET_TCP_LARGESEND)
+#  define SIM_LARGESEND (16 * 1024)
+#  define SIM_BUFSIZE   (NET_LL_HDRLEN + IPTCP_HDRLEN + SIM_LARGESEND)
+#else
+#  define SIM_BUFSIZE   (CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -85,6 +102,14 @@ struct timer
 static struct timer g_periodic_timer;
 static struct net_driver_s g_sim_dev;
 
+#ifdef CONFIG_NET_RINGS
+static uint8_t g_sim_buffers[2 * SIM_NDESC][SIM_BUFSIZE];
+static struct netdev_desc_s g_sim_txdesc[SIM_NDESC];
+static struct netdev_desc_s g_sim_rxdesc[SIM_NDESC];
+static struct netdev_ring_s g_sim_txring;
+static struct netdev_ring_s g_sim_rxring;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -123,7 +148,12 @@ static int sim_txpoll(struct net_driver_s *dev)
   if (g_sim_dev.d_len > 0)
     {
       arp_out(&g_sim_dev);
+
+      /* With descriptor rings, the frame is queued and sent later */
+
+#ifndef CONFIG_NET_RINGS
       netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
+#endif
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -133,15 +163,126 @@ static int sim_txpoll(struct net_driver_s *dev)
   return 0;
 }
 
+static int sim_input(struct net_driver_s *dev)
+{
+  /* Check for valid Ethernet header with destination == our MAC address */
+
+  if (g_sim_dev.d_len > NET_LL_HDRLEN && up_comparemac(BUF->ether_dhost, &g_sim_dev.d_mac) == 0)
+    {
+      /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv6
+      if (BUF->ether_type == htons(ETHTYPE_IP6))
+#else
+      if (BUF->ether_type == htons(ETHTYPE_IP))
+#endif
+        {
+          arp_ipin(&g_sim_dev);
+          devif_input(&g_sim_dev);
+
+         /* If the above function invocation resulted in data that
+          * should be sent out on the network, the global variable
+          * d_len is set to a value > 0.
+          */
+
+          if (g_sim_dev.d_len > 0)
+            {
+              arp_out(&g_sim_dev);
+            }
+
+          return 0;
+        }
+      else if (BUF->ether_type == htons(ETHTYPE_ARP))
+        {
+          /* An ARP reply, if any, is left in d_buf with d_len > 0 */
+
+          arp_arpin(&g_sim_dev);
+          return 0;
+        }
+    }
+
+  /* Drop the frame */
+
+  g_sim_dev.d_len = 0;
+  return 0;
+}
+
+#if defined(CONFIG_NET_RINGS) && defined(CONFIG_NET_TCP_LARGESEND)
+static int sim_segment(struct net_driver_s *dev)
+{
+  netdev_send(dev->d_buf, dev->d_len);
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_RINGS
+static void sim_transmit(void)
+{
+  FAR struct netdev_desc_s *desc;
+#ifdef CONFIG_NET_TCP_LARGESEND
+  FAR uint8_t *buf = g_sim_dev.d_buf;
+#endif
+
+  /* The TAP device sends synchronously: send all of the queued frames and
+   * free their descriptors at once.
+   */
+
+  while (!NETDEV_RING_EMPTY(&g_sim_txring))
+    {
+      desc = NETDEV_RING_TAIL(&g_sim_txring);
+#ifdef CONFIG_NET_TCP_LARGESEND
+      /* Cut the TCP large sends into segments */
+
+      g_sim_dev.d_buf = desc->nd_buf;
+      g_sim_dev.d_len = desc->nd_len;
+      g_sim_dev.d_segmss = desc->nd_segmss;
+      (void)tcp_segment(&g_sim_dev, sim_segment);
+#else
+      netdev_send(desc->nd_buf, desc->nd_len);
+#endif
+      g_sim_txring.nr_tail++;
+    }
+
+#ifdef CONFIG_NET_TCP_LARGESEND
+  g_sim_dev.d_buf = buf;
+  g_sim_dev.d_segmss = 0;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_RINGS
 void netdriver_loop(void)
 {
-  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
+  FAR struct netdev_desc_s *desc;
 
-  g_sim_dev.d_len = netdev_read((unsigned char*)g_sim_dev.d_buf, CONFIG_NET_BUFSIZE);
+  /* Read a burst of frames.  netdev_read will return 0 on a timeout event
+   * and >0 on a data received event.  Only the first frame is waited for:
+   * the rest of the burst is what is already waiting on the device.
+   */
+
+  while (!NETDEV_RING_FULL(&g_sim_rxring))
+    {
+      desc = NETDEV_RING_HEAD(&g_sim_rxring);
+      if (NETDEV_RING_EMPTY(&g_sim_rxring))
+        {
+          desc->nd_len = netdev_read(desc->nd_buf, CONFIG_NET_BUFSIZE);
+        }
+      else
+        {
+          desc->nd_len = netdev_tryread(desc->nd_buf, CONFIG_NET_BUFSIZE);
+        }
+
+      if (desc->nd_len == 0)
+        {
+          break;
+        }
+
+      g_sim_rxring.nr_head++;
+    }
 
   /* Disable preemption through to the following so that it behaves a little more
    * like an interrupt (otherwise, the following logic gets pre-empted an behaves
@@ -149,50 +290,53 @@ void netdriver_loop(void)
    */
 
   sched_lock();
-  if (g_sim_dev.d_len > 0)
+  if (!NETDEV_RING_EMPTY(&g_sim_rxring))
     {
-      /* Data received event.  Check for valid Ethernet header with destination == our
-       * MAC address
+      /* Process the received frames, then let the connections send what
+       * they can now, new data after an ACK for example.
        */
 
-      if (g_sim_dev.d_len > NET_LL_HDRLEN && up_comparemac(BUF->ether_dhost, &g_sim_dev.d_mac) == 0)
-        {
-          /* We only accept IP packets of the configured type and ARP packets */
+      (void)devif_ring_input(&g_sim_dev, &g_sim_rxring, &g_sim_txring, sim_input);
+      (void)devif_ring_poll(&g_sim_dev, &g_sim_txring, sim_txpoll);
+    }
 
-#ifdef CONFIG_NET_IPv6
-          if (BUF->ether_type == htons(ETHTYPE_IP6))
+  /* Otherwise, it must be a timeout event */
+
+  else if (timer_expired(&g_periodic_timer))
+    {
+      timer_reset(&g_periodic_timer);
+      (void)devif_ring_timer(&g_sim_dev, &g_sim_txring, sim_txpoll, 1);
+    }
+
+  sim_transmit();
+  sched_unlock();
+}
 #else
-          if (BUF->ether_type == htons(ETHTYPE_IP))
-#endif
-            {
-              arp_ipin(&g_sim_dev);
-              devif_input(&g_sim_dev);
-
-             /* If the above function invocation resulted in data that
-              * should be sent out on the network, the global variable
-              * d_len is set to a value > 0.
-              */
-
-              if (g_sim_dev.d_len > 0)
-                {
-                  arp_out(&g_sim_dev);
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
-            }
-          else if (BUF->ether_type == htons(ETHTYPE_ARP))
-            {
-              arp_arpin(&g_sim_dev);
+void netdriver_loop(void)
+{
+  /* netdev_read will return 0 on a timeout event and >0 on a data received event */
 
-              /* If the above function invocation resulted in data that
-               * should be sent out on the network, the global variable
-               * d_len is set to a value > 0.
-               */
+  g_sim_dev.d_len = netdev_read((unsigned char*)g_sim_dev.d_buf, CONFIG_NET_BUFSIZE);
 
-              if (g_sim_dev.d_len > 0)
-                {
-                  netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
-                }
-            }
+  /* Disable preemption through to the following so that it behaves a little more
+   * like an interrupt (otherwise, the following logic gets pre-empted an behaves
+   * oddly.
+   */
+
+  sched_lock();
+  if (g_sim_dev.d_len > 0)
+    {
+      /* Data received event */
+
+      sim_input(&g_sim_dev);
+
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, d_len is set to a value > 0.
+       */
+
+      if (g_sim_dev.d_len > 0)
+        {
+          netdev_send(g_sim_dev.d_buf, g_sim_dev.d_len);
         }
     }
 
@@ -205,14 +349,38 @@ void netdriver_loop(void)
     }
   sched_unlock();
 }
+#endif
 
 int netdriver_init(void)
 {
+#ifdef CONFIG_NET_RINGS
+  int i;
+#endif
+
   /* Internal initalization */
 
   timer_set(&g_periodic_timer, 500);
   netdev_init();
 
+#ifdef CONFIG_NET_RINGS
+  /* Set up the descriptor rings */
+
+  for (i = 0; i < SIM_NDESC; i++)
+    {
+      g_sim_txdesc[i].nd_buf = g_sim_buffers[i];
+      g_sim_rxdesc[i].nd_buf = g_sim_buffers[SIM_NDESC + i];
+    }
+
+  g_sim_txring.nr_desc = g_sim_txdesc;
+  g_sim_txring.nr_size = SIM_NDESC;
+  g_sim_rxring.nr_desc = g_sim_rxdesc;
+  g_sim_rxring.nr_size = SIM_NDESC;
+  g_sim_dev.d_buf      = g_sim_rxdesc[0].nd_buf;
+#ifdef CONFIG_NET_TCP_LARGESEND
+  g_sim_dev.d_largesend = SIM_LARGESEND;
+#endif
+#endif
+
   /* Register the device with the OS so that socket IOCTLs can be performed */
 
   (void)netdev_register(&g_sim_dev);
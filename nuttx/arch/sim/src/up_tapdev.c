@@ -205,7 +205,8 @@ void tapdev_init(void)
   up_setmacaddr();
 }
 
-unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
+static unsigned int tapdev_readwait(unsigned char *buf, unsigned int buflen,
+                                    long usec)
 {
   fd_set                fdset;
   struct timeval        tv;
@@ -221,7 +222,7 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
   /* Wait for data on the tap device (or a timeout) */
 
   tv.tv_sec  = 0;
-  tv.tv_usec = 1000;
+  tv.tv_usec = usec;
 
   FD_ZERO(&fdset);
   FD_SET(gtapdevfd, &fdset);
@@ -243,6 +244,18 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
   return ret;
 }
 
+unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
+{
+  return tapdev_readwait(buf, buflen, 1000);
+}
+
+/* Like tapdev_read(), but return 0 at once if no frame is waiting */
+
+unsigned int tapdev_tryread(unsigned char *buf, unsigned int buflen)
+{
+  return tapdev_readwait(buf, buflen, 0);
+}
+
 void tapdev_send(unsigned char *buf, unsigned int buflen)
 {
   int ret;
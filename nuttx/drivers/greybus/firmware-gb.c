@@ -67,6 +67,9 @@
 /* Max firmware data fetch size in bytes */
 #define GB_FIRMWARE_FETCH_MAX             2000
 
+/* The AP may have to read the firmware from storage before responding */
+#define GB_FIRMWARE_FETCH_TIMEOUT_MS      5000
+
 /* version request has no payload */
 struct gb_firmware_proto_version_response {
     __u8      major;
@@ -342,7 +345,8 @@ static int gb_firmware_get_header(
     request->offset = 0;
     request->size = GB_FIRMWARE_TFTF_HDR_SIZE;
 
-    ret = gb_operation_send_request_sync(operation);
+    ret = gb_operation_send_request_sync_timeout(operation,
+                                                 GB_FIRMWARE_FETCH_TIMEOUT_MS);
     if (ret != GB_OP_SUCCESS) {
         gb_error("failed to send firmware request\n");
         ret = -EIO;
@@ -454,7 +458,8 @@ static int gb_firmware_get_firmware(size_t size)
         request->offset = fetch_offset;
         request->size = MIN(g_firmware_info->chunk_size, remaining);
 
-        ret = gb_operation_send_request_sync(operation);
+        ret = gb_operation_send_request_sync_timeout(operation,
+                                                GB_FIRMWARE_FETCH_TIMEOUT_MS);
         if (ret != GB_OP_SUCCESS) {
             gb_error("failed to send firmware request\n");
             gb_operation_destroy(operation);
@@ -29,6 +29,7 @@
  */
 
 #include <nuttx/config.h>
+#include <nuttx/clock.h>
 #include <nuttx/list.h>
 #include <nuttx/unipro/unipro.h>
 #include <nuttx/greybus/greybus.h>
@@ -36,6 +37,7 @@
 #include <nuttx/greybus/debug.h>
 #include <nuttx/greybus/mods-ctrl.h>
 #include <nuttx/wdog.h>
+#include <nuttx/time.h>
 #include <loopback-gb.h>
 
 #include <arch/atomic.h>
@@ -44,6 +46,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/time.h>
 
 #include "rtr.h"
 
@@ -51,23 +55,88 @@
 #define TIMEOUT_IN_MS           1000
 #define GB_INVALID_TYPE         0
 
-#define ONE_SEC_IN_MSEC         1000
-#define ONE_MSEC_IN_NSEC        1000000
+/*
+ * Number of slots of the timer wheel holding the deadlines of the requests
+ * waiting for a response. A slot covers one system tick, requests whose
+ * timeout is longer than a full turn of the wheel stay in their slot for
+ * several turns. Must be a power of two.
+ */
+#define GB_TIMER_WHEEL_SIZE     128
+
+/*
+ * Number of buckets of the in-flight request table. Operation ids are
+ * allocated from a single counter shared by all cports, so the low bits of
+ * the id spread outstanding requests evenly and buckets rarely hold more
+ * than one entry. Must be a power of two.
+ */
+#define GB_INFLIGHT_TBL_SIZE    32
+
+/*
+ * Number of buckets of the dispatch latency histogram. Bucket n counts the
+ * messages that waited less than 2^n us between their reception and their
+ * processing, the last bucket counts everything above.
+ */
+#define GB_DISPATCH_HIST_SIZE   16
 
-#define TIMEOUT_WD_DELAY    (TIMEOUT_IN_MS * CLOCKS_PER_SEC) / ONE_SEC_IN_MSEC
+#ifdef CONFIG_GREYBUS_RX_RING
+#define GB_RX_RING_SIZE         CONFIG_GREYBUS_RX_RING_SIZE
+#define GB_RX_RING_MASK         (GB_RX_RING_SIZE - 1)
+
+#if (GB_RX_RING_SIZE & GB_RX_RING_MASK) || GB_RX_RING_SIZE > 32768
+#error "CONFIG_GREYBUS_RX_RING_SIZE must be a power of two up to 32768"
+#endif
+#endif
 
 struct gb_cport_driver {
     struct gb_driver *driver;
     struct list_head tx_fifo;
+#ifdef CONFIG_GREYBUS_RX_RING
+    /*
+     * rx_head is only written by greybus_rx_handler() and rx_tail by the
+     * thread serving the cport, so neither side needs to disable interrupts.
+     */
+    struct gb_operation * volatile rx_ring[GB_RX_RING_SIZE];
+    volatile uint16_t rx_head;
+    volatile uint16_t rx_tail;
+    volatile bool timedout_pending;
+#else
     struct list_head rx_fifo;
+#endif
     sem_t rx_fifo_lock;
     pthread_t thread;
     volatile bool exit_worker;
-    struct wdog_s timeout_wd;
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    bool pooled;
+    bool scheduled; /* in the run queue or being processed by a worker */
+    uint8_t priority;
+    size_t stack_size;
+    struct list_head runq;
+#endif
+#ifdef CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS
+    uint32_t dispatch_hist[GB_DISPATCH_HIST_SIZE];
+#endif
+    struct gb_rx_pool *rx_pool;
+    struct list_head expired;
     struct gb_operation timedout_operation;
     uint16_t cport;
 };
 
+/*
+ * Pool of operations, with their request buffer, used to receive the
+ * messages of a cport without going through the heap.
+ */
+struct gb_rx_pool {
+    struct list_head free_ops;
+    struct gb_operation *ops;
+    size_t buf_size;
+    unsigned int count;
+    unsigned int used;
+    unsigned int high_watermark;
+    unsigned int exhausted;
+    unsigned int oversized;
+    bool orphan; /* cport unregistered, release when last op is freed */
+};
+
 struct gb_tape_record_header {
     uint16_t size;
     uint16_t cport;
@@ -75,6 +144,26 @@ struct gb_tape_record_header {
 
 static atomic_t request_id;
 
+static struct list_head inflight_tbl[GB_INFLIGHT_TBL_SIZE];
+
+static unsigned int dedicated_threads;
+
+static struct list_head timer_wheel[GB_TIMER_WHEEL_SIZE];
+static struct wdog_s timer_wd;
+static uint32_t timer_tick; /* next tick to be processed */
+static uint32_t timer_next; /* tick timer_wd is armed for */
+static unsigned int timer_count;
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+static struct list_head runq[GB_WORKER_PRIO_COUNT];
+static sem_t runq_lock;
+static pthread_t pool_threads[CONFIG_GREYBUS_WORKER_POOL_SIZE];
+static unsigned int pool_nthreads;
+static volatile bool pool_exit;
+static unsigned int pooled_cports;
+static size_t pooled_stack;
+#endif
+
 static void **cport_tbl;
 
 static struct gb_cport_driver *_g_cport(unsigned int cport)
@@ -96,6 +185,106 @@ bool gb_is_valid_cport(unsigned int cport)
 static struct gb_transport_backend *transport_backend;
 static struct gb_tape_mechanism *gb_tape;
 static int gb_tape_fd = -EBADFD;
+
+#define GB_TAPE_ALIGN(x)        (((x) + 3) & ~3)
+
+#ifdef CONFIG_GREYBUS_TAPE_ASYNC
+#define GB_TAPE_RING_SIZE       CONFIG_GREYBUS_TAPE_RING_SIZE
+#define GB_TAPE_RING_MASK       (GB_TAPE_RING_SIZE - 1)
+#define GB_TAPE_RECORD_READY    (1 << 15) /* record fully copied in the ring */
+#define GB_TAPE_RECORD_WRAP     (1 << 14) /* end of the ring is unused */
+
+#if GB_TAPE_RING_SIZE & GB_TAPE_RING_MASK
+#error "CONFIG_GREYBUS_TAPE_RING_SIZE must be a power of two"
+#endif
+
+/*
+ * Messages are copied in the ring by the RX and TX paths and written to the
+ * tape by a low priority thread. Space is reserved with interrupts disabled
+ * but the copy is done with interrupts enabled: a record is only written to
+ * the tape once its READY flag is set.
+ */
+static uint8_t *gb_tape_ring;
+static volatile uint32_t gb_tape_head;
+static volatile uint32_t gb_tape_tail;
+static bool gb_tape_recording;
+static unsigned int gb_tape_dropped;
+static struct timespec gb_tape_start;
+static pthread_t gb_tape_thread;
+static volatile bool gb_tape_exit;
+
+#define gb_tape_record_flags(rec) (*(volatile uint16_t *) &(rec)->flags)
+
+static void gb_tape_record(unsigned int cport, const void *data, size_t size,
+                           uint16_t flags)
+{
+    struct gb_tape_timed_record_header *rec;
+    struct timespec now;
+    struct timespec delta;
+    size_t len = sizeof(*rec) + GB_TAPE_ALIGN(size);
+    uint32_t head;
+    uint32_t off;
+    uint32_t skip;
+    irqstate_t irq_flags;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    irq_flags = irqsave();
+
+    if (!gb_tape_recording) {
+        irqrestore(irq_flags);
+        return;
+    }
+
+    /* records are never split across the end of the ring */
+    head = gb_tape_head;
+    off = head & GB_TAPE_RING_MASK;
+    skip = GB_TAPE_RING_SIZE - off < len ? GB_TAPE_RING_SIZE - off : 0;
+
+    if (head + skip + len - gb_tape_tail > GB_TAPE_RING_SIZE) {
+        gb_tape_dropped++;
+        irqrestore(irq_flags);
+        return;
+    }
+
+    if (skip >= sizeof(*rec)) {
+        rec = (struct gb_tape_timed_record_header *) &gb_tape_ring[off];
+        gb_tape_record_flags(rec) = GB_TAPE_RECORD_WRAP | GB_TAPE_RECORD_READY;
+    }
+
+    rec = (struct gb_tape_timed_record_header *)
+              &gb_tape_ring[(head + skip) & GB_TAPE_RING_MASK];
+    gb_tape_record_flags(rec) = 0;
+    gb_tape_head = head + skip + len;
+
+    irqrestore(irq_flags);
+
+    timespecsub(&now, &gb_tape_start, &delta);
+    rec->size = size;
+    rec->cport = cport;
+    rec->timestamp = timespec_to_usec(&delta);
+    rec->reserved = 0;
+    memcpy(rec + 1, data, size);
+
+    gb_tape_record_flags(rec) = flags | GB_TAPE_RECORD_READY;
+}
+#else
+static void gb_tape_record(unsigned int cport, const void *data, size_t size,
+                           uint16_t flags)
+{
+    struct gb_tape_record_header record_hdr = {
+        .size = size,
+        .cport = cport,
+    };
+
+    /* only received messages are replayed, and writes are synchronous */
+    if (!gb_tape || gb_tape_fd < 0 || (flags & GB_TAPE_RECORD_TX))
+        return;
+
+    gb_tape->write(gb_tape_fd, &record_hdr, sizeof(record_hdr));
+    gb_tape->write(gb_tape_fd, data, size);
+}
+#endif
 static struct gb_operation_hdr *timedout_hdr;
 static struct gb_operation_hdr *oom_hdr;
 
@@ -105,9 +294,11 @@ static void g_cport_add_entry(uint16_t cport, struct gb_driver *driver)
 
     if (entry) {
         sem_init(&entry->rx_fifo_lock, 0, 0);
+#ifndef CONFIG_GREYBUS_RX_RING
         list_init(&entry->rx_fifo);
+#endif
         list_init(&entry->tx_fifo);
-        wd_static(&entry->timeout_wd);
+        list_init(&entry->expired);
         entry->timedout_operation.request_buffer = timedout_hdr;
         list_init(&entry->timedout_operation.list);
         entry->driver = driver;
@@ -127,8 +318,201 @@ static inline void g_cport_remove_entry(uint16_t cport)
 	}
 }
 
-static void gb_operation_timeout(int argc, uint32_t cport, ...);
 static struct gb_operation *_gb_operation_create(unsigned int cport);
+static void gb_rx_fifo_push_timedout(struct gb_cport_driver *entry);
+static void gb_timer_wheel_expire(int argc, uint32_t arg1, ...);
+
+static inline struct list_head *gb_timer_slot(uint32_t tick)
+{
+    return &timer_wheel[tick & (GB_TIMER_WHEEL_SIZE - 1)];
+}
+
+/**
+ * Arm the timer wheel watchdog for the first slot that is not empty
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_timer_wheel_arm(uint32_t now)
+{
+    uint32_t tick;
+
+    if (!timer_count) {
+        wd_cancel(&timer_wd);
+        return;
+    }
+
+    for (tick = timer_tick; tick != timer_tick + GB_TIMER_WHEEL_SIZE; tick++) {
+        if (!list_is_empty(gb_timer_slot(tick)))
+            break;
+    }
+
+    timer_next = tick;
+    wd_start(&timer_wd, (int32_t) (tick - now) > 0 ? tick - now : 1,
+             gb_timer_wheel_expire, 0);
+}
+
+/**
+ * Start the timeout of a request
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_timer_add(struct gb_operation *operation,
+                         unsigned int timeout_ms)
+{
+    uint32_t now = clock_systimer();
+    int32_t delay = MSEC2TICK(timeout_ms);
+
+    if (delay <= 0)
+        delay = 1;
+
+    if (!timer_count)
+        timer_tick = now + 1;
+
+    operation->deadline = now + delay;
+    list_add(gb_timer_slot(operation->deadline), &operation->timer);
+    timer_count++;
+
+    if (!WDOG_ISACTIVE(&timer_wd) ||
+        (int32_t) (operation->deadline - timer_next) < 0) {
+        timer_next = operation->deadline;
+        wd_start(&timer_wd, delay, gb_timer_wheel_expire, 0);
+    }
+}
+
+/**
+ * Stop the timeout of a request
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_timer_del(struct gb_operation *operation)
+{
+    if (list_is_empty(&operation->timer))
+        return;
+
+    list_del(&operation->timer);
+    if (!--timer_count)
+        wd_cancel(&timer_wd);
+}
+
+static inline struct list_head *gb_inflight_bucket(uint16_t id)
+{
+    return &inflight_tbl[id & (GB_INFLIGHT_TBL_SIZE - 1)];
+}
+
+/**
+ * Add a request waiting for a response to the cport tx_fifo and to the
+ * in-flight table
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_inflight_add(struct gb_operation *operation,
+                            unsigned int timeout_ms)
+{
+    struct gb_operation_hdr *hdr = operation->request_buffer;
+
+    list_add(&g_cport(operation->cport).tx_fifo, &operation->list);
+    list_add(gb_inflight_bucket(le16_to_cpu(hdr->id)), &operation->inflight);
+    gb_timer_add(operation, timeout_ms);
+}
+
+/**
+ * Remove a request from the cport tx_fifo, from the in-flight table and
+ * from the timer wheel
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_inflight_del(struct gb_operation *operation)
+{
+    list_del(&operation->list);
+    list_del(&operation->inflight);
+    gb_timer_del(operation);
+}
+
+/**
+ * Move a request that timed out to the expired list of its cport, and let
+ * the thread serving the cport know about it.
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_operation_expire(struct gb_operation *operation)
+{
+    struct gb_cport_driver *entry = _g_cport(operation->cport);
+
+    gb_inflight_del(operation);
+    list_add(&entry->expired, &operation->list);
+    gb_rx_fifo_push_timedout(entry);
+}
+
+static void gb_timer_wheel_expire(int argc, uint32_t arg1, ...)
+{
+    irqstate_t flags;
+    struct list_head *iter, *iter_next;
+    struct gb_operation *op;
+    uint32_t now = clock_systimer();
+    uint32_t nslots;
+    uint32_t i;
+
+    flags = irqsave();
+
+    /*
+     * Process every slot up to the current tick. Only the requests whose
+     * deadline has been reached are touched, the others are waiting for a
+     * later turn of the wheel.
+     */
+    nslots = now - timer_tick + 1;
+    if ((int32_t) nslots > 0) {
+        if (nslots > GB_TIMER_WHEEL_SIZE)
+            nslots = GB_TIMER_WHEEL_SIZE;
+
+        for (i = 0; i < nslots; i++) {
+            list_foreach_safe(gb_timer_slot(timer_tick + i), iter, iter_next) {
+                op = list_entry(iter, struct gb_operation, timer);
+                if ((int32_t) (op->deadline - now) > 0)
+                    continue;
+
+                gb_operation_expire(op);
+            }
+        }
+
+        timer_tick = now + 1;
+    }
+
+    gb_timer_wheel_arm(now);
+
+    irqrestore(flags);
+}
+
+/**
+ * Find and remove the request matching a response
+ *
+ * @param cport cport the response has been received on
+ * @param id operation id of the response (little endian)
+ * @return the matching request, or NULL if no request is waiting for this id
+ */
+static struct gb_operation *gb_inflight_take(unsigned int cport, __le16 id)
+{
+    irqstate_t flags;
+    struct list_head *iter;
+    struct gb_operation *op;
+    struct gb_operation_hdr *op_hdr;
+
+    flags = irqsave();
+
+    list_foreach(gb_inflight_bucket(le16_to_cpu(id)), iter) {
+        op = list_entry(iter, struct gb_operation, inflight);
+        op_hdr = op->request_buffer;
+
+        if (op->cport != cport || op_hdr->id != id)
+            continue;
+
+        gb_inflight_del(op);
+        irqrestore(flags);
+        return op;
+    }
+
+    irqrestore(flags);
+    return NULL;
+}
 
 uint8_t gb_errno_to_op_result(int err)
 {
@@ -252,153 +636,584 @@ static void gb_process_request(struct gb_operation_hdr *hdr,
     op_mark_send_time(operation);
 }
 
-static bool gb_operation_has_timedout(struct gb_operation *operation)
+static void gb_clean_timedout_operation(unsigned int cport)
 {
-    struct timespec current_time;
-    struct timespec timeout_time;
+    irqstate_t flags;
+    struct list_head *head;
+    struct gb_operation *op;
 
-    timeout_time.tv_sec = operation->time.tv_sec +
-                          TIMEOUT_IN_MS / ONE_SEC_IN_MSEC;
-    timeout_time.tv_nsec = operation->time.tv_nsec +
-                          (TIMEOUT_IN_MS % ONE_SEC_IN_MSEC) * ONE_MSEC_IN_NSEC;
-    clock_gettime(CLOCK_MONOTONIC, &current_time);
+    flags = irqsave();
 
-    if (current_time.tv_sec > timeout_time.tv_sec)
-        return true;
+    while (!list_is_empty(&g_cport(cport).expired)) {
+        head = g_cport(cport).expired.next;
+        list_del(head);
+        irqrestore(flags);
 
-    if (current_time.tv_sec < timeout_time.tv_sec)
-        return false;
+        op = list_entry(head, struct gb_operation, list);
+        if (op->callback) {
+            op->callback(op);
+        }
+        gb_operation_unref(op);
 
-    return current_time.tv_nsec > timeout_time.tv_nsec;
+        flags = irqsave();
+    }
+
+    irqrestore(flags);
 }
 
+static void gb_process_response(struct gb_operation_hdr *hdr,
+                                struct gb_operation *operation)
+{
+    struct gb_operation *op;
+
+    op = gb_inflight_take(operation->cport, hdr->id);
+    if (op) {
+        /* attach this response with the original request */
+        gb_operation_ref(operation);
+        op->response = operation;
+        op_mark_recv_time(op);
+        if (op->callback)
+            op->callback(op);
+        gb_operation_unref(op);
+        return;
+    }
+
+    gb_error("CPort %u: cannot find matching request for response %hu. Dropping message.\n",
+             operation->cport, le16_to_cpu(hdr->id));
+}
+
+#ifdef CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS
+static void gb_dispatch_account(struct gb_cport_driver *entry,
+                                struct gb_operation *operation)
+{
+    struct timespec now;
+    struct timespec delta;
+    useconds_t latency;
+    int i;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    timespecsub(&now, &operation->recv_ts, &delta);
+    latency = timespec_to_usec(&delta);
+
+    for (i = 0; i < GB_DISPATCH_HIST_SIZE - 1; i++) {
+        if (latency < (1 << i))
+            break;
+    }
+
+    entry->dispatch_hist[i]++;
+}
+#else
+static void gb_dispatch_account(struct gb_cport_driver *entry,
+                                struct gb_operation *operation) { }
+#endif
+
+static void gb_process_message(struct gb_cport_driver *entry,
+                               struct gb_operation *operation)
+{
+    struct gb_operation_hdr *hdr = operation->request_buffer;
+
+    if (hdr == timedout_hdr) {
+        gb_clean_timedout_operation(entry->cport);
+        return;
+    }
+
+    gb_dispatch_account(entry, operation);
+
+    if (hdr->type & GB_TYPE_RESPONSE_FLAG)
+        gb_process_response(hdr, operation);
+    else
+        gb_process_request(hdr, operation);
+    gb_operation_destroy(operation);
+}
+
+#ifdef CONFIG_GREYBUS_RX_RING
 /**
- * Update watchdog state
- *
- * Cancel cport watchdog if there is no outgoing message waiting for a response,
- * or update the watchdog if there is still outgoing messages.
+ * Remove the oldest message from a cport rx_fifo
  *
- * TODO use fine-grain timeout delay when doing the update
+ * @note Only the thread serving the cport may call this function
+ * @return the message, or NULL if the rx_fifo is empty
+ */
+static struct gb_operation *gb_rx_fifo_pop(struct gb_cport_driver *entry)
+{
+    struct gb_operation *operation;
+    uint16_t tail = entry->rx_tail;
+
+    if (entry->timedout_pending) {
+        entry->timedout_pending = false;
+        return &entry->timedout_operation;
+    }
+
+    if (tail == entry->rx_head)
+        return NULL;
+
+    operation = entry->rx_ring[tail & GB_RX_RING_MASK];
+    entry->rx_tail = tail + 1;
+    return operation;
+}
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+static bool gb_rx_fifo_is_empty(struct gb_cport_driver *entry)
+{
+    return !entry->timedout_pending && entry->rx_tail == entry->rx_head;
+}
+#endif
+#else
+/**
+ * Remove the oldest message from a cport rx_fifo
  *
- * @note This function should be called from an atomic context
+ * @return the message, or NULL if the rx_fifo is empty
  */
-static void gb_watchdog_update(unsigned int cport)
+static struct gb_operation *gb_rx_fifo_pop(struct gb_cport_driver *entry)
 {
+    struct list_head *head = NULL;
     irqstate_t flags;
 
     flags = irqsave();
+    if (!list_is_empty(&entry->rx_fifo)) {
+        head = entry->rx_fifo.next;
+        list_del(head);
+    }
+    irqrestore(flags);
 
-    if (list_is_empty(&g_cport(cport).tx_fifo)) {
-        wd_cancel(&g_cport(cport).timeout_wd);
-    } else {
-        wd_start(&g_cport(cport).timeout_wd, TIMEOUT_WD_DELAY,
-                 gb_operation_timeout, 1, cport);
+    return head ? list_entry(head, struct gb_operation, list) : NULL;
+}
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+static bool gb_rx_fifo_is_empty(struct gb_cport_driver *entry)
+{
+    return list_is_empty(&entry->rx_fifo);
+}
+#endif
+#endif
+
+static void *gb_pending_message_worker(void *data)
+{
+    const int cportid = (int) data;
+    struct gb_cport_driver *entry = _g_cport(cportid);
+    struct gb_operation *operation;
+    int retval;
+
+    while (1) {
+        retval = sem_wait(&entry->rx_fifo_lock);
+        if (retval < 0)
+            continue;
+
+        /*
+         * With CONFIG_GREYBUS_RX_RING the worker is only woken up when its
+         * rx_fifo stops being empty, so always drain it.
+         */
+        while ((operation = gb_rx_fifo_pop(entry)))
+            gb_process_message(entry, operation);
+
+        if (entry->exit_worker)
+            break;
     }
 
-    irqrestore(flags);
+    return NULL;
 }
 
-static void gb_clean_timedout_operation(unsigned int cport)
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+/**
+ * Queue a cport in the run queue of the worker pool
+ *
+ * A cport is queued at most once and is only processed by one worker at a
+ * time, which preserves the ordering of its messages.
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_runq_schedule(struct gb_cport_driver *entry)
+{
+    if (entry->scheduled)
+        return;
+
+    entry->scheduled = true;
+    list_add(&runq[entry->priority], &entry->runq);
+    sem_post(&runq_lock);
+}
+
+/**
+ * Get the next cport to process, highest priority first
+ *
+ * @note This function should be called from an atomic context
+ */
+static struct gb_cport_driver *gb_runq_pop(void)
+{
+    struct list_head *head;
+    int prio;
+
+    for (prio = GB_WORKER_PRIO_COUNT - 1; prio >= 0; prio--) {
+        if (list_is_empty(&runq[prio]))
+            continue;
+
+        head = runq[prio].next;
+        list_del(head);
+        return list_entry(head, struct gb_cport_driver, runq);
+    }
+
+    return NULL;
+}
+
+static void *gb_pool_worker(void *data)
 {
     irqstate_t flags;
-    struct list_head *iter, *iter_next;
-    struct gb_operation *op;
+    struct gb_cport_driver *entry;
+    struct gb_operation *operation;
+    int retval;
 
-    list_foreach_safe(&g_cport(cport).tx_fifo, iter, iter_next) {
-        op = list_entry(iter, struct gb_operation, list);
+    while (1) {
+        retval = sem_wait(&runq_lock);
+        if (retval < 0)
+            continue;
+
+        if (pool_exit)
+            break;
 
-        if (!gb_operation_has_timedout(op)) {
+        flags = irqsave();
+        entry = gb_runq_pop();
+        irqrestore(flags);
+        if (!entry)
             continue;
-        }
 
+        operation = gb_rx_fifo_pop(entry);
+        if (operation)
+            gb_process_message(entry, operation);
+
+        /*
+         * Only one message is processed per turn so that a busy cport cannot
+         * starve the other cports of the same priority: requeue the cport at
+         * the tail of the run queue if it still has pending messages.
+         */
         flags = irqsave();
-        list_del(iter);
+        entry->scheduled = false;
+        if (!gb_rx_fifo_is_empty(entry))
+            gb_runq_schedule(entry);
+        else if (entry->exit_worker)
+            sem_post(&entry->rx_fifo_lock);
         irqrestore(flags);
+    }
 
-        if (op->callback) {
-            op->callback(op);
-        }
-        gb_operation_unref(op);
+    return NULL;
+}
+
+static int gb_pool_start(void)
+{
+    pthread_attr_t thread_attr;
+    int retval;
+
+    retval = pthread_attr_init(&thread_attr);
+    if (retval)
+        return retval;
+
+    retval = pthread_attr_setstacksize(&thread_attr,
+                                       CONFIG_GREYBUS_WORKER_POOL_STACKSIZE);
+    if (retval)
+        goto out;
+
+    pool_exit = false;
+    while (pool_nthreads < CONFIG_GREYBUS_WORKER_POOL_SIZE) {
+        retval = pthread_create(&pool_threads[pool_nthreads], &thread_attr,
+                                gb_pool_worker, NULL);
+        if (retval)
+            break;
+        pool_nthreads++;
+    }
+
+    /* A partial pool is still able to serve the cports */
+    if (pool_nthreads > 0)
+        retval = 0;
+
+out:
+    pthread_attr_destroy(&thread_attr);
+    return retval;
+}
+
+static void gb_pool_stop(void)
+{
+    unsigned int i;
+
+    pool_exit = true;
+    for (i = 0; i < pool_nthreads; i++)
+        sem_post(&runq_lock);
+
+    for (i = 0; i < pool_nthreads; i++)
+        pthread_join(pool_threads[i], NULL);
+
+    pool_nthreads = 0;
+}
+
+static int gb_pool_attach(unsigned int cport, struct gb_driver *driver)
+{
+    struct gb_cport_driver *entry = _g_cport(cport);
+    int retval;
+
+    if (!pool_nthreads) {
+        retval = gb_pool_start();
+        if (retval)
+            return retval;
     }
 
-    gb_watchdog_update(cport);
+    entry->pooled = true;
+    entry->priority = driver->priority;
+    entry->stack_size = driver->stack_size;
+    list_init(&entry->runq);
+
+    pooled_cports++;
+    pooled_stack += entry->stack_size;
+
+    return 0;
 }
 
-static void gb_process_response(struct gb_operation_hdr *hdr,
-                                struct gb_operation *operation)
+static void gb_pool_detach(unsigned int cport)
 {
+    struct gb_cport_driver *entry = _g_cport(cport);
     irqstate_t flags;
-    struct list_head *iter, *iter_next;
-    struct gb_operation *op;
-    struct gb_operation_hdr *op_hdr;
+    bool busy;
+    int retval;
 
-    list_foreach_safe(&g_cport(operation->cport).tx_fifo, iter, iter_next) {
-        op = list_entry(iter, struct gb_operation, list);
-        op_hdr = op->request_buffer;
+    flags = irqsave();
+    entry->exit_worker = true;
+    busy = entry->scheduled;
+    irqrestore(flags);
 
-        if (hdr->id != op_hdr->id)
-            continue;
+    /* Wait for the workers to drain the cport rx_fifo */
+    if (busy) {
+        do {
+            retval = sem_wait(&entry->rx_fifo_lock);
+        } while (retval < 0 && errno == EINTR);
+    }
+
+    pooled_cports--;
+    pooled_stack -= entry->stack_size;
+}
+#endif
+
+/**
+ * Wake up the thread serving a cport
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_cport_wake(struct gb_cport_driver *entry)
+{
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    if (entry->pooled) {
+        gb_runq_schedule(entry);
+        return;
+    }
+#endif
+
+    sem_post(&entry->rx_fifo_lock);
+}
 
+#ifdef CONFIG_GREYBUS_RX_RING
+/**
+ * Queue a message on a cport rx_fifo and wake up the thread serving the cport
+ * if the rx_fifo was empty
+ *
+ * @note Must not be called concurrently for the same cport
+ * @return 0 on success, -ENOSPC if the rx_fifo is full
+ */
+static int gb_rx_fifo_push(struct gb_cport_driver *entry,
+                           struct gb_operation *operation)
+{
+    uint16_t head = entry->rx_head;
+    irqstate_t flags;
+
+    if ((uint16_t)(head - entry->rx_tail) == GB_RX_RING_SIZE)
+        return -ENOSPC;
+
+    entry->rx_ring[head & GB_RX_RING_MASK] = operation;
+    entry->rx_head = head + 1;
+
+    /*
+     * Only check for emptiness once the message is visible: if the thread
+     * has not consumed everything before it, it has yet to go back to sleep
+     * and will see the message.
+     */
+    if (entry->rx_tail == head) {
         flags = irqsave();
-        list_del(iter);
-        gb_watchdog_update(operation->cport);
+        gb_cport_wake(entry);
         irqrestore(flags);
+    }
 
-        /* attach this response with the original request */
-        gb_operation_ref(operation);
-        op->response = operation;
-        op_mark_recv_time(op);
-        if (op->callback)
-            op->callback(op);
-        gb_operation_unref(op);
+    return 0;
+}
+
+/**
+ * Let the thread serving a cport know that some of its requests timed out
+ *
+ * The timed out marker does not go through the ring since it is queued from
+ * the timer, which would make a second producer.
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_rx_fifo_push_timedout(struct gb_cport_driver *entry)
+{
+    if (entry->timedout_pending)
         return;
+
+    entry->timedout_pending = true;
+    gb_cport_wake(entry);
+}
+#else
+/**
+ * Queue a message on a cport rx_fifo and wake up the thread serving the cport
+ *
+ * @return 0
+ */
+static int gb_rx_fifo_push(struct gb_cport_driver *entry,
+                           struct gb_operation *operation)
+{
+    irqstate_t flags;
+
+    flags = irqsave();
+    list_add(&entry->rx_fifo, &operation->list);
+    gb_cport_wake(entry);
+    irqrestore(flags);
+
+    return 0;
+}
+
+/**
+ * Let the thread serving a cport know that some of its requests timed out
+ *
+ * @note This function should be called from an atomic context
+ */
+static void gb_rx_fifo_push_timedout(struct gb_cport_driver *entry)
+{
+    /* timedout operation could potentially already been queued */
+    if (!list_is_empty(&entry->timedout_operation.list))
+        return;
+
+    list_add(&entry->rx_fifo, &entry->timedout_operation.list);
+    gb_cport_wake(entry);
+}
+#endif
+
+#if !defined(CONFIG_UNIPRO_ZERO_COPY)
+static void gb_rx_pool_destroy(struct gb_rx_pool *pool)
+{
+    unsigned int i;
+
+    for (i = 0; i < pool->count; i++)
+        transport_backend->free_buf(pool->ops[i].request_headroom);
+
+    free(pool->ops);
+    free(pool);
+}
+
+static struct gb_rx_pool *gb_rx_pool_create(unsigned int count,
+                                            size_t payload_size)
+{
+    struct gb_rx_pool *pool;
+    struct gb_operation *op;
+    unsigned int i;
+
+    pool = zalloc(sizeof(*pool));
+    if (!pool)
+        return NULL;
+
+    pool->ops = zalloc(count * sizeof(*pool->ops));
+    if (!pool->ops) {
+        free(pool);
+        return NULL;
     }
 
-    gb_error("CPort %u: cannot find matching request for response %hu. Dropping message.\n",
-             operation->cport, le16_to_cpu(hdr->id));
+    list_init(&pool->free_ops);
+    pool->buf_size = payload_size + sizeof(struct gb_operation_hdr);
+
+    for (i = 0; i < count; i++) {
+        op = &pool->ops[i];
+
+        op->request_headroom =
+            transport_backend->alloc_buf(pool->buf_size +
+                                         transport_backend->headroom);
+        if (!op->request_headroom) {
+            gb_rx_pool_destroy(pool);
+            return NULL;
+        }
+
+        op->rx_pool = pool;
+        list_add(&pool->free_ops, &op->list);
+        pool->count++;
+    }
+
+    return pool;
 }
 
-static void *gb_pending_message_worker(void *data)
+/**
+ * Mark a pool as no longer used by its cport, and release it if none of its
+ * operations are still referenced.
+ */
+static void gb_rx_pool_release(struct gb_rx_pool *pool)
+{
+    irqstate_t flags;
+    bool release;
+
+    flags = irqsave();
+    pool->orphan = true;
+    release = !pool->used;
+    irqrestore(flags);
+
+    if (release)
+        gb_rx_pool_destroy(pool);
+}
+
+static struct gb_operation *gb_rx_pool_alloc(struct gb_rx_pool *pool,
+                                             unsigned int cport)
 {
-    const int cportid = (int) data;
     irqstate_t flags;
-    struct gb_operation *operation;
     struct list_head *head;
-    struct gb_operation_hdr *hdr;
-    int retval;
+    struct gb_operation *op;
+    void *headroom;
 
-    while (1) {
-        retval = sem_wait(&g_cport(cportid).rx_fifo_lock);
-        if (retval < 0)
-            continue;
+    flags = irqsave();
+
+    if (list_is_empty(&pool->free_ops)) {
+        pool->exhausted++;
+        irqrestore(flags);
+        return NULL;
+    }
+
+    head = pool->free_ops.next;
+    list_del(head);
+
+    if (++pool->used > pool->high_watermark)
+        pool->high_watermark = pool->used;
+
+    irqrestore(flags);
 
-        if (g_cport(cportid).exit_worker &&
-            list_is_empty(&g_cport(cportid).rx_fifo)) {
-            break;
-        }
+    op = list_entry(head, struct gb_operation, list);
+    headroom = op->request_headroom;
 
-        flags = irqsave();
-        head = g_cport(cportid).rx_fifo.next;
-        list_del(g_cport(cportid).rx_fifo.next);
-        irqrestore(flags);
+    memset(op, 0, sizeof(*op));
+    op->cport = cport;
+    op->rx_pool = pool;
+    op->request_headroom = headroom;
+    op->request_buffer = (char *)headroom + transport_backend->headroom;
+    list_init(&op->list);
+    list_init(&op->inflight);
+    list_init(&op->timer);
+    atomic_init(&op->ref_count, 1);
 
-        operation = list_entry(head, struct gb_operation, list);
-        hdr = operation->request_buffer;
+    return op;
+}
 
-        if (hdr == timedout_hdr) {
-            gb_clean_timedout_operation(cportid);
-            continue;
-        }
+static void gb_rx_pool_free(struct gb_operation *operation)
+{
+    struct gb_rx_pool *pool = operation->rx_pool;
+    irqstate_t flags;
+    bool release;
 
-        if (hdr->type & GB_TYPE_RESPONSE_FLAG)
-            gb_process_response(hdr, operation);
-        else
-            gb_process_request(hdr, operation);
-        gb_operation_destroy(operation);
-    }
+    flags = irqsave();
+    list_add(&pool->free_ops, &operation->list);
+    pool->used--;
+    release = pool->orphan && !pool->used;
+    irqrestore(flags);
 
-    return NULL;
+    if (release)
+        gb_rx_pool_destroy(pool);
 }
+#endif
 
 #if defined(CONFIG_UNIPRO_ZERO_COPY)
 static struct gb_operation *gb_rx_create_operation(unsigned cport, void *data,
@@ -406,11 +1221,10 @@ static struct gb_operation *gb_rx_create_operation(unsigned cport, void *data,
 {
     struct gb_operation *op;
 
-    if (transport_backend->headroom) {
-        gb_error("headroom allocation cannot be used with zero copy\n");
-        return NULL;
-    }
-
+    /*
+     * The request buffer is never handed back to the transport, so it does
+     * not need any headroom: only responses are allocated with some.
+     */
     op = _gb_operation_create(cport);
     if (!op)
         return NULL;
@@ -425,11 +1239,23 @@ static struct gb_operation *gb_rx_create_operation(unsigned cport, void *data,
 static struct gb_operation *gb_rx_create_operation(unsigned cport, void *data,
                                                    size_t size)
 {
-    struct gb_operation *op;
+    struct gb_rx_pool *pool = g_cport(cport).rx_pool;
+    struct gb_operation *op = NULL;
 
-    op = gb_operation_create(cport, 0, size - sizeof(struct gb_operation_hdr));
-    if (!op)
-        return NULL;
+    if (pool) {
+        if (size <= pool->buf_size)
+            op = gb_rx_pool_alloc(pool, cport);
+        else
+            pool->oversized++;
+    }
+
+    /* Fall back to the heap if the pool is empty or the message too big */
+    if (!op) {
+        op = gb_operation_create(cport, 0,
+                                 size - sizeof(struct gb_operation_hdr));
+        if (!op)
+            return NULL;
+    }
 
     memcpy(op->request_buffer, data, size);
 
@@ -439,7 +1265,6 @@ static struct gb_operation *gb_rx_create_operation(unsigned cport, void *data,
 
 int greybus_rx_handler(unsigned int cport, void *data, size_t size)
 {
-    irqstate_t flags;
     struct gb_operation *op;
     struct gb_operation_hdr *hdr = data;
     struct gb_operation_handler *op_handler;
@@ -469,16 +1294,7 @@ int greybus_rx_handler(unsigned int cport, void *data, size_t size)
     }
 
     gb_dump(data, size);
-
-    if (gb_tape && gb_tape_fd >= 0) {
-        struct gb_tape_record_header record_hdr = {
-            .size = size,
-            .cport = cport,
-        };
-
-        gb_tape->write(gb_tape_fd, &record_hdr, sizeof(record_hdr));
-        gb_tape->write(gb_tape_fd, data, size);
-    }
+    gb_tape_record(cport, data, size, 0);
 
     op_handler = find_operation_handler(hdr->type, cport);
     if (op_handler && op_handler->fast_handler) {
@@ -493,24 +1309,59 @@ int greybus_rx_handler(unsigned int cport, void *data, size_t size)
 
     op_mark_recv_time(op);
 
-    flags = irqsave();
-    list_add(&g_cport(cport).rx_fifo, &op->list);
-    sem_post(&g_cport(cport).rx_fifo_lock);
-    irqrestore(flags);
+    if (gb_rx_fifo_push(_g_cport(cport), op)) {
+        gb_error("CPort %u: rx_fifo full, dropping message\n", cport);
+        gb_operation_destroy(op);
+        return -ENOMEM;
+    }
 
     return 0;
 }
 
+/**
+ * Drop the requests of a cport still waiting for a response, and take them
+ * out of the timer wheel so that none of them can expire and wake up the
+ * thread serving the cport any more.
+ */
+static void gb_flush_inflight(unsigned int cport)
+{
+    irqstate_t flags;
+    struct gb_operation *op;
+
+    /* requests can expire concurrently, so always pick the head of the list */
+    flags = irqsave();
+
+    while (!list_is_empty(&g_cport(cport).tx_fifo)) {
+        op = list_entry(g_cport(cport).tx_fifo.next, struct gb_operation, list);
+        gb_inflight_del(op);
+        irqrestore(flags);
+
+        gb_operation_unref(op);
+        flags = irqsave();
+    }
+
+    irqrestore(flags);
+}
+
 static void gb_flush_tx_fifo(unsigned int cport)
 {
-    struct list_head *iter, *iter_next;
+    irqstate_t flags;
+    struct gb_operation *op;
 
-    list_foreach_safe(&_g_cport(cport)->tx_fifo, iter, iter_next) {
-        struct gb_operation *op = list_entry(iter, struct gb_operation, list);
+    gb_flush_inflight(cport);
+
+    flags = irqsave();
+
+    while (!list_is_empty(&g_cport(cport).expired)) {
+        op = list_entry(g_cport(cport).expired.next, struct gb_operation, list);
+        list_del(&op->list);
+        irqrestore(flags);
 
-        list_del(iter);
         gb_operation_unref(op);
+        flags = irqsave();
     }
+
+    irqrestore(flags);
 }
 
 int gb_unregister_driver(unsigned int cport)
@@ -522,11 +1373,20 @@ int gb_unregister_driver(unsigned int cport)
     if (transport_backend->stop_listening)
         transport_backend->stop_listening(cport);
 
-    wd_cancel(&g_cport(cport).timeout_wd);
+    /* A timeout must not wake up the cport once its worker is gone */
+    gb_flush_inflight(cport);
 
-    g_cport(cport).exit_worker = true;
-    sem_post(&g_cport(cport).rx_fifo_lock);
-    pthread_join(g_cport(cport).thread, NULL);
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    if (g_cport(cport).pooled) {
+        gb_pool_detach(cport);
+    } else
+#endif
+    {
+        g_cport(cport).exit_worker = true;
+        sem_post(&g_cport(cport).rx_fifo_lock);
+        pthread_join(g_cport(cport).thread, NULL);
+        dedicated_threads--;
+    }
 
     gb_flush_tx_fifo(cport);
 
@@ -534,6 +1394,13 @@ int gb_unregister_driver(unsigned int cport)
         g_cport(cport).driver->exit(cport);
     _g_cport(cport)->driver = NULL;
 
+#if !defined(CONFIG_UNIPRO_ZERO_COPY)
+    if (g_cport(cport).rx_pool) {
+        gb_rx_pool_release(g_cport(cport).rx_pool);
+        g_cport(cport).rx_pool = NULL;
+    }
+#endif
+
     return 0;
 }
 
@@ -570,6 +1437,11 @@ int _gb_register_driver(unsigned int cport, struct gb_driver *driver)
         return -EINVAL;
     }
 
+    if (driver->priority >= GB_WORKER_PRIO_COUNT) {
+        gb_error("Invalid worker priority\n");
+        return -EINVAL;
+    }
+
     if (driver->init) {
         retval = driver->init(cport);
         if (retval) {
@@ -583,11 +1455,44 @@ int _gb_register_driver(unsigned int cport, struct gb_driver *driver)
               sizeof(*driver->op_handlers), gb_compare_handlers);
     }
 
-    g_cport(cport).exit_worker = false;
-
     if (!driver->stack_size)
         driver->stack_size = DEFAULT_STACK_SIZE;
 
+    gb_debug("add cport %d\n", cport);
+    g_cport_add_entry(cport, NULL);
+
+    g_cport(cport).exit_worker = false;
+
+#if !defined(CONFIG_UNIPRO_ZERO_COPY)
+    if (driver->rx_pool_count) {
+        g_cport(cport).rx_pool =
+            gb_rx_pool_create(driver->rx_pool_count,
+                              driver->rx_pool_payload_size ?
+                                driver->rx_pool_payload_size :
+                                GB_MAX_PAYLOAD_SIZE);
+        if (!g_cport(cport).rx_pool) {
+            retval = -ENOMEM;
+            goto pthread_attr_init_error;
+        }
+    }
+#endif
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    /*
+     * Drivers that need a bigger stack than the one of the pool workers are
+     * given a dedicated thread, like the ones asking for it explicitly.
+     */
+    if (!driver->dedicated_worker &&
+        driver->stack_size <= CONFIG_GREYBUS_WORKER_POOL_STACKSIZE) {
+        retval = gb_pool_attach(cport, driver);
+        if (retval)
+            goto pthread_attr_init_error;
+
+        _g_cport(cport)->driver = driver;
+        return 0;
+    }
+#endif
+
     retval = pthread_attr_init(&thread_attr);
     if (retval)
         goto pthread_attr_init_error;
@@ -596,9 +1501,6 @@ int _gb_register_driver(unsigned int cport, struct gb_driver *driver)
     if (retval)
         goto pthread_attr_setstacksize_error;
 
-    gb_debug("add cport %d\n", cport);
-    g_cport_add_entry(cport, NULL);
-
     retval = pthread_create(&g_cport(cport).thread, &thread_attr,
                             gb_pending_message_worker, (unsigned*) cport);
     if (retval)
@@ -608,6 +1510,7 @@ int _gb_register_driver(unsigned int cport, struct gb_driver *driver)
     thread_attr_ptr = NULL;
 
     _g_cport(cport)->driver = driver;
+    dedicated_threads++;
 
     return 0;
 
@@ -617,6 +1520,12 @@ pthread_attr_setstacksize_error:
         pthread_attr_destroy(&thread_attr);
 pthread_attr_init_error:
     gb_error("Can not create thread for %s\n: ", gb_driver_name(driver));
+#if !defined(CONFIG_UNIPRO_ZERO_COPY)
+    if (g_cport(cport).rx_pool) {
+        gb_rx_pool_release(g_cport(cport).rx_pool);
+        g_cport(cport).rx_pool = NULL;
+    }
+#endif
     if (driver->exit)
         driver->exit(cport);
     return retval;
@@ -659,26 +1568,78 @@ int gb_stop_listening(unsigned int cport)
     return transport_backend->stop_listening(cport);
 }
 
-static void gb_operation_timeout(int argc, uint32_t cport, ...)
+/* request_id is atomic: this need not be called from an atomic context */
+static void gb_operation_set_request_id(struct gb_operation *operation,
+                                        bool need_response)
 {
-    irqstate_t flags;
+    struct gb_operation_hdr *hdr = operation->request_buffer;
 
-    flags = irqsave();
+    hdr->id = 0;
 
-    /* timedout operation could potentially already been queued */
-    if (!list_is_empty(&g_cport(cport).timedout_operation.list)) {
-        irqrestore(flags);
-        return;
+    if (need_response) {
+        hdr->id = cpu_to_le16(atomic_inc(&request_id));
+        if (hdr->id == 0) /* ID 0 is for request with no response */
+            hdr->id = cpu_to_le16(atomic_inc(&request_id));
     }
+}
 
-    list_add(&g_cport(cport).rx_fifo, &g_cport(cport).timedout_operation.list);
-    sem_post(&g_cport(cport).rx_fifo_lock);
-    irqrestore(flags);
+/* Must be called with interrupts disabled */
+static void gb_operation_prepare_request(struct gb_operation *operation,
+                                         gb_operation_callback callback,
+                                         bool need_response,
+                                         unsigned int timeout_ms)
+{
+    if (need_response) {
+        operation->callback = callback;
+        gb_operation_ref(operation);
+        gb_inflight_add(operation, timeout_ms);
+    }
 }
 
-int gb_operation_send_request(struct gb_operation *operation,
-                              gb_operation_callback callback,
-                              bool need_response)
+/* Must be called with interrupts disabled */
+static void gb_operation_cancel_request(struct gb_operation *operation)
+{
+    gb_inflight_del(operation);
+    gb_operation_unref(operation);
+}
+
+static void gb_operation_send_done(int status, void *priv)
+{
+    struct gb_operation *operation = priv;
+
+    if (status)
+        gb_error("Greybus backend failed to send: error %d\n", status);
+
+    gb_operation_unref(operation);
+}
+
+/*
+ * Hand an operation buffer over to the transport. With send_async(), the
+ * buffer is not copied: the operation is kept alive, and so its buffers,
+ * until the backend is done with it.
+ */
+static int gb_operation_transmit(struct gb_operation *operation,
+                                 const void *buf, size_t len)
+{
+    int retval;
+
+    if (!transport_backend->send_async)
+        return transport_backend->send(operation->cport, buf, len);
+
+    gb_operation_ref(operation);
+    retval = transport_backend->send_async(operation->cport, buf, len,
+                                           gb_operation_send_done,
+                                           operation);
+    if (retval)
+        gb_operation_unref(operation);
+
+    return retval;
+}
+
+static int _gb_operation_send_request(struct gb_operation *operation,
+                                      gb_operation_callback callback,
+                                      bool need_response,
+                                      unsigned int timeout_ms)
 {
     struct gb_operation_hdr *hdr = operation->request_buffer;
     int retval = 0;
@@ -691,53 +1652,66 @@ int gb_operation_send_request(struct gb_operation *operation,
     if (g_cport(operation->cport).exit_worker)
         return -ENETDOWN;
 
-    hdr->id = 0;
+    /* the request is final once it has its id: record it before irqsave */
+    gb_operation_set_request_id(operation, need_response);
+    gb_dump(operation->request_buffer, hdr->size);
+    gb_tape_record(operation->cport, operation->request_buffer,
+                   le16_to_cpu(hdr->size), GB_TAPE_RECORD_TX);
 
     flags = irqsave();
 
-    if (need_response) {
-        hdr->id = cpu_to_le16(atomic_inc(&request_id));
-        if (hdr->id == 0) /* ID 0 is for request with no response */
-            hdr->id = cpu_to_le16(atomic_inc(&request_id));
-        clock_gettime(CLOCK_MONOTONIC, &operation->time);
-        operation->callback = callback;
-        gb_operation_ref(operation);
-        list_add(&g_cport(operation->cport).tx_fifo, &operation->list);
-        if (!WDOG_ISACTIVE(&g_cport(operation->cport).timeout_wd)) {
-            wd_start(&g_cport(operation->cport).timeout_wd, TIMEOUT_WD_DELAY,
-                     gb_operation_timeout, 1, operation->cport);
-        }
-    }
-
-    gb_dump(operation->request_buffer, hdr->size);
-    retval = transport_backend->send(operation->cport,
-                                     operation->request_buffer,
-                                     le16_to_cpu(hdr->size));
+    gb_operation_prepare_request(operation, callback, need_response,
+                                 timeout_ms);
+    retval = gb_operation_transmit(operation, operation->request_buffer,
+                                   le16_to_cpu(hdr->size));
     op_mark_send_time(operation);
-    if (need_response && retval) {
-        list_del(&operation->list);
-        gb_watchdog_update(operation->cport);
-        gb_operation_unref(operation);
-    }
+    if (need_response && retval)
+        gb_operation_cancel_request(operation);
 
     irqrestore(flags);
 
     return retval;
 }
 
+int gb_operation_send_request(struct gb_operation *operation,
+                              gb_operation_callback callback,
+                              bool need_response)
+{
+    return _gb_operation_send_request(operation, callback, need_response,
+                                      TIMEOUT_IN_MS);
+}
+
+/**
+ * Send a request waiting for a response with a specific timeout
+ *
+ * @param operation request to send
+ * @param callback function called when the response is received or when the
+ *        request timed out
+ * @param timeout_ms delay after which the request times out, in milliseconds
+ * @return 0 on success, a negative errno otherwise
+ */
+int gb_operation_send_request_timeout(struct gb_operation *operation,
+                                      gb_operation_callback callback,
+                                      unsigned int timeout_ms)
+{
+    return _gb_operation_send_request(operation, callback, true, timeout_ms);
+}
+
 static void gb_operation_callback_sync(struct gb_operation *operation)
 {
     sem_post(&operation->sync_sem);
 }
 
-int gb_operation_send_request_sync(struct gb_operation *operation)
+int gb_operation_send_request_sync_timeout(struct gb_operation *operation,
+                                           unsigned int timeout_ms)
 {
     int retval;
 
     sem_init(&operation->sync_sem, 0, 0);
 
-    retval =
-        gb_operation_send_request(operation, gb_operation_callback_sync, true);
+    retval = gb_operation_send_request_timeout(operation,
+                                               gb_operation_callback_sync,
+                                               timeout_ms);
     if (retval)
         return retval;
 
@@ -748,37 +1722,205 @@ int gb_operation_send_request_sync(struct gb_operation *operation)
     return retval;
 }
 
-static int gb_operation_send_oom_response(struct gb_operation *operation)
+int gb_operation_send_request_sync(struct gb_operation *operation)
+{
+    return gb_operation_send_request_sync_timeout(operation, TIMEOUT_IN_MS);
+}
+
+static int gb_operation_send_oom_response(struct gb_operation *operation)
+{
+    struct gb_operation_hdr oom_resp;
+    int retval;
+    irqstate_t flags;
+    struct gb_operation_hdr *req_hdr = operation->request_buffer;
+
+    if (g_cport(operation->cport).exit_worker)
+        return -ENETDOWN;
+
+    /* oom_hdr is shared between cports: record a copy before irqsave */
+    oom_resp = *oom_hdr;
+    oom_resp.id = req_hdr->id;
+    oom_resp.type = GB_TYPE_RESPONSE_FLAG | req_hdr->type;
+    gb_tape_record(operation->cport, &oom_resp, sizeof(oom_resp),
+                   GB_TAPE_RECORD_TX);
+
+    flags = irqsave();
+
+    oom_hdr->id = req_hdr->id;
+    oom_hdr->type = GB_TYPE_RESPONSE_FLAG | req_hdr->type;
+
+    /* oom_hdr is shared between cports: always have it copied */
+    retval = transport_backend->send(operation->cport, oom_hdr,
+                                     sizeof(*oom_hdr));
+
+    irqrestore(flags);
+
+    return retval;
+}
+
+static int gb_operation_prepare_response(struct gb_operation *operation,
+                                         uint8_t result,
+                                         bool *has_allocated_response)
+{
+    struct gb_operation_hdr *resp_hdr;
+
+    *has_allocated_response = false;
+
+    if (!operation->response_buffer) {
+        gb_operation_alloc_response(operation, 0);
+        if (!operation->response_buffer)
+            return -ENOMEM;
+
+        *has_allocated_response = true;
+    }
+
+    resp_hdr = operation->response_buffer;
+    resp_hdr->result = result;
+
+    gb_loopback_log_exit(operation->cport, operation, resp_hdr->size);
+    return 0;
+}
+
+static void gb_operation_release_response(struct gb_operation *operation,
+                                          bool has_allocated_response)
+{
+    if (!has_allocated_response)
+        return;
+
+    gb_debug("Free the response buffer\n");
+    transport_backend->free_buf(operation->response_headroom);
+    operation->response_headroom = NULL;
+    operation->response_buffer = NULL;
+}
+
+int gb_operation_send_response(struct gb_operation *operation, uint8_t result)
+{
+    struct gb_operation_hdr *resp_hdr;
+    int retval;
+    bool has_allocated_response;
+
+    DEBUGASSERT(operation);
+    DEBUGASSERT(transport_backend);
+    DEBUGASSERT(transport_backend->send);
+
+    if (g_cport(operation->cport).exit_worker)
+        return -ENETDOWN;
+
+    if (operation->has_responded)
+        return -EINVAL;
+
+    retval = gb_operation_prepare_response(operation, result,
+                                           &has_allocated_response);
+    if (retval)
+        return gb_operation_send_oom_response(operation);
+
+    resp_hdr = operation->response_buffer;
+
+    gb_dump(operation->response_buffer, resp_hdr->size);
+    gb_tape_record(operation->cport, operation->response_buffer,
+                   le16_to_cpu(resp_hdr->size), GB_TAPE_RECORD_TX);
+    retval = gb_operation_transmit(operation, operation->response_buffer,
+                                   le16_to_cpu(resp_hdr->size));
+    if (retval) {
+        gb_error("Greybus backend failed to send: error %d\n", retval);
+        gb_operation_release_response(operation, has_allocated_response);
+        return retval;
+    }
+
+    operation->has_responded = true;
+    return retval;
+}
+
+#define GB_BATCH_RESPONSE           (1 << 0)
+#define GB_BATCH_NEED_RESPONSE      (1 << 1)
+#define GB_BATCH_ALLOCATED_RESPONSE (1 << 2)
+
+/**
+ * Initialize an empty batch of operations
+ *
+ * @param batch batch to initialize
+ */
+void gb_operation_batch_init(struct gb_operation_batch *batch)
+{
+    DEBUGASSERT(batch);
+    batch->count = 0;
+}
+
+static int gb_operation_batch_add(struct gb_operation_batch *batch,
+                                  struct gb_operation *operation,
+                                  uint8_t flags)
+{
+    gb_operation_ref(operation);
+
+    batch->entries[batch->count].operation = operation;
+    batch->entries[batch->count].flags = flags;
+    batch->count++;
+
+    if (batch->count == GB_BATCH_MAX_OPS)
+        return gb_operation_batch_flush(batch);
+
+    return 0;
+}
+
+/**
+ * Queue a request in a batch
+ *
+ * The request is registered (and its timeout started) right away but is only
+ * handed to the transport backend by gb_operation_batch_flush().
+ *
+ * @param batch batch in which to queue the request
+ * @param operation request to send
+ * @param callback function called when the response is received or when the
+ *        request timed out
+ * @param need_response true if the request expects a response
+ * @return 0 on success, a negative errno otherwise. Queuing the last free
+ *         slot flushes the batch and returns the result of the flush.
+ */
+int gb_operation_batch_request(struct gb_operation_batch *batch,
+                               struct gb_operation *operation,
+                               gb_operation_callback callback,
+                               bool need_response)
 {
-    int retval;
     irqstate_t flags;
-    struct gb_operation_hdr *req_hdr = operation->request_buffer;
+
+    DEBUGASSERT(batch);
+    DEBUGASSERT(operation);
+    DEBUGASSERT(batch->count < GB_BATCH_MAX_OPS);
 
     if (g_cport(operation->cport).exit_worker)
         return -ENETDOWN;
 
-    flags = irqsave();
-
-    oom_hdr->id = req_hdr->id;
-    oom_hdr->type = GB_TYPE_RESPONSE_FLAG | req_hdr->type;
-
-    retval = transport_backend->send(operation->cport, oom_hdr,
-                                     sizeof(*oom_hdr));
+    gb_operation_set_request_id(operation, need_response);
 
+    flags = irqsave();
+    gb_operation_prepare_request(operation, callback, need_response,
+                                 TIMEOUT_IN_MS);
     irqrestore(flags);
 
-    return retval;
+    return gb_operation_batch_add(batch, operation,
+                                  need_response ? GB_BATCH_NEED_RESPONSE : 0);
 }
 
-int gb_operation_send_response(struct gb_operation *operation, uint8_t result)
+/**
+ * Queue a response in a batch
+ *
+ * @param batch batch in which to queue the response
+ * @param operation operation to respond to
+ * @param result result of the operation
+ * @return 0 on success, a negative errno otherwise. Queuing the last free
+ *         slot flushes the batch and returns the result of the flush.
+ */
+int gb_operation_batch_response(struct gb_operation_batch *batch,
+                                struct gb_operation *operation,
+                                uint8_t result)
 {
-    struct gb_operation_hdr *resp_hdr;
+    uint8_t flags = GB_BATCH_RESPONSE;
+    bool has_allocated_response;
     int retval;
-    bool has_allocated_response = false;
 
+    DEBUGASSERT(batch);
     DEBUGASSERT(operation);
-    DEBUGASSERT(transport_backend);
-    DEBUGASSERT(transport_backend->send);
+    DEBUGASSERT(batch->count < GB_BATCH_MAX_OPS);
 
     if (g_cport(operation->cport).exit_worker)
         return -ENETDOWN;
@@ -786,34 +1928,110 @@ int gb_operation_send_response(struct gb_operation *operation, uint8_t result)
     if (operation->has_responded)
         return -EINVAL;
 
-    if (!operation->response_buffer) {
-        gb_operation_alloc_response(operation, 0);
-        if (!operation->response_buffer)
-            return gb_operation_send_oom_response(operation);
+    retval = gb_operation_prepare_response(operation, result,
+                                           &has_allocated_response);
+    if (retval)
+        return gb_operation_send_oom_response(operation);
 
-        has_allocated_response = true;
-    }
+    if (has_allocated_response)
+        flags |= GB_BATCH_ALLOCATED_RESPONSE;
 
-    resp_hdr = operation->response_buffer;
-    resp_hdr->result = result;
+    operation->has_responded = true;
+    return gb_operation_batch_add(batch, operation, flags);
+}
+
+static void gb_operation_batch_complete(struct gb_operation_batch *batch,
+                                        unsigned int i, int retval)
+{
+    struct gb_operation *operation = batch->entries[i].operation;
+    uint8_t flags = batch->entries[i].flags;
+    irqstate_t irq_flags;
+
+    if (!(flags & GB_BATCH_RESPONSE))
+        op_mark_send_time(operation);
 
-    gb_dump(operation->response_buffer, resp_hdr->size);
-    gb_loopback_log_exit(operation->cport, operation, resp_hdr->size);
-    retval = transport_backend->send(operation->cport,
-                                     operation->response_buffer,
-                                     le16_to_cpu(resp_hdr->size));
     if (retval) {
-        gb_error("Greybus backend failed to send: error %d\n", retval);
-        if (has_allocated_response) {
-            gb_debug("Free the response buffer\n");
-            transport_backend->free_buf(operation->response_headroom);
-            operation->response_headroom = NULL;
-            operation->response_buffer = NULL;
+        if (flags & GB_BATCH_RESPONSE) {
+            operation->has_responded = false;
+            gb_operation_release_response(operation,
+                                flags & GB_BATCH_ALLOCATED_RESPONSE);
+        } else if (flags & GB_BATCH_NEED_RESPONSE) {
+            irq_flags = irqsave();
+            gb_operation_cancel_request(operation);
+            irqrestore(irq_flags);
         }
-        return retval;
     }
 
-    operation->has_responded = true;
+    gb_operation_unref(operation);
+}
+
+/**
+ * Hand all the operations of a batch to the transport backend
+ *
+ * Backends implementing send_batch() get the whole batch in a single call,
+ * even if they also implement send_async(). The others get one call per
+ * operation. Operations that could not be sent are released as if their
+ * send had failed.
+ *
+ * @param batch batch to flush, empty on return
+ * @return 0 on success, the first error returned by the backend otherwise
+ */
+int gb_operation_batch_flush(struct gb_operation_batch *batch)
+{
+    struct gb_transport_msg msgs[GB_BATCH_MAX_OPS];
+    struct gb_operation_hdr *hdr;
+    struct gb_operation *operation;
+    unsigned int sent;
+    unsigned int i;
+    int retval = 0;
+    int ret;
+
+    DEBUGASSERT(batch);
+    DEBUGASSERT(transport_backend);
+    DEBUGASSERT(transport_backend->send);
+
+    if (!batch->count)
+        return 0;
+
+    for (i = 0; i < batch->count; i++) {
+        operation = batch->entries[i].operation;
+        hdr = batch->entries[i].flags & GB_BATCH_RESPONSE ?
+                    operation->response_buffer : operation->request_buffer;
+
+        msgs[i].cport = operation->cport;
+        msgs[i].buf = hdr;
+        msgs[i].len = le16_to_cpu(hdr->size);
+        gb_dump((void *)hdr, le16_to_cpu(hdr->size));
+        gb_tape_record(msgs[i].cport, msgs[i].buf, msgs[i].len,
+                       GB_TAPE_RECORD_TX);
+    }
+
+    if (transport_backend->send_batch) {
+        ret = transport_backend->send_batch(msgs, batch->count);
+        sent = ret < 0 ? 0 : ret;
+        if (sent < batch->count) {
+            retval = ret < 0 ? ret : -EIO;
+            gb_error("Greybus backend failed to send batch: error %d\n",
+                     retval);
+        }
+
+        for (i = 0; i < batch->count; i++)
+            gb_operation_batch_complete(batch, i, i < sent ? 0 : retval);
+    } else {
+        for (i = 0; i < batch->count; i++) {
+            ret = gb_operation_transmit(batch->entries[i].operation,
+                                        msgs[i].buf, msgs[i].len);
+            if (ret) {
+                gb_error("Greybus backend failed to send: error %d\n", ret);
+                if (!retval)
+                    retval = ret;
+            }
+
+            gb_operation_batch_complete(batch, i, ret);
+        }
+    }
+
+    batch->count = 0;
     return retval;
 }
 
@@ -869,7 +2087,7 @@ void gb_operation_unref(struct gb_operation *operation)
 
     if (operation->is_unipro_rx_buf) {
         unipro_rxbuf_free(operation->cport, operation->request_headroom);
-    } else {
+    } else if (!operation->rx_pool) {
         transport_backend->free_buf(operation->request_headroom);
     }
 
@@ -877,6 +2095,14 @@ void gb_operation_unref(struct gb_operation *operation)
     if (operation->response) {
         gb_operation_unref(operation->response);
     }
+
+#if !defined(CONFIG_UNIPRO_ZERO_COPY)
+    if (operation->rx_pool) {
+        gb_rx_pool_free(operation);
+        return;
+    }
+#endif
+
     free(operation);
 }
 
@@ -895,6 +2121,8 @@ static struct gb_operation *_gb_operation_create(unsigned int cport)
     operation->cport = cport;
 
     list_init(&operation->list);
+    list_init(&operation->inflight);
+    list_init(&operation->timer);
     atomic_init(&operation->ref_count, 1);
 
     return operation;
@@ -970,6 +2198,8 @@ uint8_t gb_operation_get_request_result(struct gb_operation *operation)
 
 int gb_init(struct gb_transport_backend *transport)
 {
+    int i;
+
     if (!transport)
         return -EINVAL;
 
@@ -1002,6 +2232,19 @@ int gb_init(struct gb_transport_backend *transport)
 
     cport_tbl = rtr_alloc_table();
 
+    for (i = 0; i < GB_INFLIGHT_TBL_SIZE; i++)
+        list_init(&inflight_tbl[i]);
+
+    for (i = 0; i < GB_TIMER_WHEEL_SIZE; i++)
+        list_init(&timer_wheel[i]);
+    wd_static(&timer_wd);
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    for (i = 0; i < GB_WORKER_PRIO_COUNT; i++)
+        list_init(&runq[i]);
+    sem_init(&runq_lock, 0, 0);
+#endif
+
     atomic_init(&request_id, (uint32_t) 0);
 
     transport_backend = transport;
@@ -1028,7 +2271,6 @@ void gb_deinit(void)
 
         gb_unregister_driver(i);
 
-        wd_delete(&drv->timeout_wd);
         sem_destroy(&drv->rx_fifo_lock);
 
         g_cport_remove_entry(i);
@@ -1037,11 +2279,125 @@ void gb_deinit(void)
     rtr_free_table(cport_tbl);
     cport_tbl = NULL;
 
+    wd_cancel(&timer_wd);
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    gb_pool_stop();
+    sem_destroy(&runq_lock);
+#endif
+
     if (transport_backend->exit)
         transport_backend->exit();
     transport_backend = NULL;
 }
 
+#ifdef CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS
+static unsigned int gb_dispatch_percentile(const uint32_t *hist,
+                                           unsigned int percent)
+{
+    uint32_t total = 0;
+    uint32_t count = 0;
+    uint32_t target;
+    int i;
+
+    for (i = 0; i < GB_DISPATCH_HIST_SIZE; i++)
+        total += hist[i];
+
+    if (!total)
+        return 0;
+
+    target = (total * percent + 99) / 100;
+    for (i = 0; i < GB_DISPATCH_HIST_SIZE - 1; i++) {
+        count += hist[i];
+        if (count >= target)
+            break;
+    }
+
+    return 1 << i;
+}
+#endif
+
+/**
+ * Get the message dispatch statistics of a cport
+ *
+ * Latency percentiles are upper bounds, in microseconds, of the time spent
+ * by the messages between their reception and their processing. They are
+ * only available when CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS is set.
+ *
+ * @param cport cport number
+ * @param stats pointer to the statistics container
+ * @return 0 on success, -EINVAL if the cport is not registered
+ */
+int gb_get_dispatch_stats(unsigned int cport, struct gb_dispatch_stats *stats)
+{
+    if (!stats || !gb_is_valid_cport(cport) || !_g_cport(cport))
+        return -EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+
+#ifdef CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS
+    stats->latency_p50 = gb_dispatch_percentile(g_cport(cport).dispatch_hist,
+                                                50);
+    stats->latency_p90 = gb_dispatch_percentile(g_cport(cport).dispatch_hist,
+                                                90);
+    stats->latency_p99 = gb_dispatch_percentile(g_cport(cport).dispatch_hist,
+                                                99);
+#endif
+
+    stats->dedicated_threads = dedicated_threads;
+
+#ifdef CONFIG_GREYBUS_WORKER_POOL
+    stats->pool_threads = pool_nthreads;
+    stats->pooled_cports = pooled_cports;
+    stats->stack_saved = (ssize_t) pooled_stack -
+        (ssize_t) (pool_nthreads * CONFIG_GREYBUS_WORKER_POOL_STACKSIZE);
+#endif
+
+    return 0;
+}
+
+/**
+ * Get the statistics of the receive operation pool of a cport
+ *
+ * @param cport cport number
+ * @param stats pointer to the statistics container
+ * @return 0 on success, -EINVAL if the cport is not registered, -ENOENT if
+ *         the cport has no receive pool
+ */
+int gb_get_rx_pool_stats(unsigned int cport, struct gb_rx_pool_stats *stats)
+{
+    struct gb_rx_pool *pool;
+    irqstate_t flags;
+
+    if (!stats || !gb_is_valid_cport(cport) || !_g_cport(cport))
+        return -EINVAL;
+
+    pool = g_cport(cport).rx_pool;
+    if (!pool)
+        return -ENOENT;
+
+    flags = irqsave();
+    stats->size = pool->count;
+    stats->used = pool->used;
+    stats->high_watermark = pool->high_watermark;
+    stats->exhausted = pool->exhausted;
+    stats->oversized = pool->oversized;
+    irqrestore(flags);
+
+    return 0;
+}
+
+void gb_reset_dispatch_stats(unsigned int cport)
+{
+    if (!gb_is_valid_cport(cport) || !_g_cport(cport))
+        return;
+
+#ifdef CONFIG_GREYBUS_FEATURE_HAVE_TIMESTAMPS
+    memset(g_cport(cport).dispatch_hist, 0,
+           sizeof(g_cport(cport).dispatch_hist));
+#endif
+}
+
 int gb_tape_register_mechanism(struct gb_tape_mechanism *mechanism)
 {
     if (!mechanism || !mechanism->open || !mechanism->close ||
@@ -1056,6 +2412,146 @@ int gb_tape_register_mechanism(struct gb_tape_mechanism *mechanism)
     return 0;
 }
 
+#ifdef CONFIG_GREYBUS_TAPE_ASYNC
+/**
+ * Write all the records of the ring that are ready to the tape, in as few
+ * writes as possible
+ */
+static void gb_tape_drain(void)
+{
+    struct gb_tape_timed_record_header *rec;
+    uint32_t tail = gb_tape_tail;
+    uint32_t off;
+    uint32_t len;
+    uint16_t flags = 0;
+
+    while (tail != gb_tape_head) {
+        off = tail & GB_TAPE_RING_MASK;
+
+        for (len = 0; tail + len != gb_tape_head &&
+                      GB_TAPE_RING_SIZE - (off + len) >= sizeof(*rec);
+             len += sizeof(*rec) + GB_TAPE_ALIGN(rec->size)) {
+            rec = (struct gb_tape_timed_record_header *)
+                      &gb_tape_ring[off + len];
+            flags = gb_tape_record_flags(rec);
+            if (!(flags & GB_TAPE_RECORD_READY) ||
+                (flags & GB_TAPE_RECORD_WRAP))
+                break;
+        }
+
+        if (len) {
+            gb_tape->write(gb_tape_fd, &gb_tape_ring[off], len);
+        } else if (GB_TAPE_RING_SIZE - off < sizeof(*rec) ||
+                   (flags & GB_TAPE_RECORD_WRAP)) {
+            len = GB_TAPE_RING_SIZE - off;
+        } else {
+            break; /* the oldest record is still being copied */
+        }
+
+        tail += len;
+        gb_tape_tail = tail;
+    }
+}
+
+static void *gb_tape_drain_worker(void *data)
+{
+    while (!gb_tape_exit) {
+        gb_tape_drain();
+        usleep(CONFIG_GREYBUS_TAPE_DRAIN_PERIOD * 1000);
+    }
+
+    /* Records reserved before the capture stopped may still be copied */
+    while (gb_tape_tail != gb_tape_head) {
+        gb_tape_drain();
+        if (gb_tape_tail != gb_tape_head)
+            usleep(1000);
+    }
+
+    return NULL;
+}
+
+static int gb_tape_start_recorder(void)
+{
+    struct sched_param param;
+    pthread_attr_t thread_attr;
+    uint32_t magic = GB_TAPE_TIMED_MAGIC;
+    int retval;
+
+    if (gb_tape->write(gb_tape_fd, &magic, sizeof(magic)) != sizeof(magic))
+        return -EIO;
+
+    gb_tape_ring = malloc(GB_TAPE_RING_SIZE);
+    if (!gb_tape_ring)
+        return -ENOMEM;
+
+    gb_tape_head = 0;
+    gb_tape_tail = 0;
+    gb_tape_dropped = 0;
+    gb_tape_exit = false;
+    clock_gettime(CLOCK_REALTIME, &gb_tape_start);
+
+    retval = pthread_attr_init(&thread_attr);
+    if (retval)
+        goto error_attr_init;
+
+    param.sched_priority = CONFIG_GREYBUS_TAPE_DRAIN_PRIORITY;
+    retval = pthread_attr_setschedparam(&thread_attr, &param);
+    if (retval)
+        goto error_attr;
+
+    retval = pthread_create(&gb_tape_thread, &thread_attr,
+                            gb_tape_drain_worker, NULL);
+    if (retval)
+        goto error_attr;
+
+    pthread_attr_destroy(&thread_attr);
+
+    gb_tape_recording = true;
+    return 0;
+
+error_attr:
+    pthread_attr_destroy(&thread_attr);
+error_attr_init:
+    free(gb_tape_ring);
+    gb_tape_ring = NULL;
+    return -retval;
+}
+
+static void gb_tape_stop_recorder(void)
+{
+    irqstate_t flags;
+
+    flags = irqsave();
+    gb_tape_recording = false;
+    irqrestore(flags);
+
+    gb_tape_exit = true;
+    pthread_join(gb_tape_thread, NULL);
+
+    free(gb_tape_ring);
+    gb_tape_ring = NULL;
+
+    if (gb_tape_dropped)
+        lowsyslog("greybus: %u records dropped from the tape\n",
+                  gb_tape_dropped);
+}
+
+/**
+ * Get the number of records dropped because the capture ring was full
+ *
+ * @return number of records dropped since the start of the last capture
+ */
+unsigned int gb_tape_dropped_records(void)
+{
+    return gb_tape_dropped;
+}
+#else
+unsigned int gb_tape_dropped_records(void)
+{
+    return 0;
+}
+#endif
+
 int gb_tape_communication(const char *pathname)
 {
     if (!gb_tape)
@@ -1068,6 +2564,17 @@ int gb_tape_communication(const char *pathname)
     if (gb_tape_fd < 0)
         return gb_tape_fd;
 
+#ifdef CONFIG_GREYBUS_TAPE_ASYNC
+    {
+        int retval = gb_tape_start_recorder();
+        if (retval) {
+            gb_tape->close(gb_tape_fd);
+            gb_tape_fd = -EBADFD;
+            return retval;
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -1076,15 +2583,99 @@ int gb_tape_stop(void)
     if (!gb_tape || gb_tape_fd < 0)
         return -EINVAL;
 
+#ifdef CONFIG_GREYBUS_TAPE_ASYNC
+    gb_tape_stop_recorder();
+#endif
+
     gb_tape->close(gb_tape_fd);
     gb_tape_fd = -EBADFD;
 
     return 0;
 }
 
+static int gb_tape_replay_untimed(int fd, char *buffer,
+                                  struct gb_tape_record_header *hdr)
+{
+    ssize_t nread;
+
+    while (1) {
+        nread = gb_tape->read(fd, buffer, hdr->size);
+        if (hdr->size != nread) {
+            gb_error("gb-tape: invalid byte count read, aborting...\n");
+            return -EIO;
+        }
+
+        greybus_rx_handler(hdr->cport, buffer, nread);
+
+        nread = gb_tape->read(fd, hdr, sizeof(*hdr));
+        if (!nread)
+            return 0;
+
+        if (nread != sizeof(*hdr)) {
+            gb_error("gb-tape: invalid byte count read, aborting...\n");
+            return -EIO;
+        }
+    }
+}
+
+/*
+ * Replay the received messages of a timed tape, waiting between them as long
+ * as they were apart during the capture.
+ */
+static int gb_tape_replay_timed(int fd, char *buffer)
+{
+    struct gb_tape_timed_record_header hdr;
+    struct timespec start;
+    struct timespec now;
+    struct timespec delta;
+    uint32_t first = 0;
+    uint32_t elapsed;
+    bool started = false;
+    ssize_t nread;
+    size_t len;
+
+    while (1) {
+        nread = gb_tape->read(fd, &hdr, sizeof(hdr));
+        if (!nread)
+            return 0;
+
+        len = GB_TAPE_ALIGN(hdr.size);
+        if (nread != sizeof(hdr) || len > CPORT_BUF_SIZE) {
+            gb_error("gb-tape: invalid record, aborting...\n");
+            return -EIO;
+        }
+
+        nread = gb_tape->read(fd, buffer, len);
+        if (nread != len) {
+            gb_error("gb-tape: invalid byte count read, aborting...\n");
+            return -EIO;
+        }
+
+        if (hdr.flags & GB_TAPE_RECORD_TX)
+            continue;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (!started) {
+            start = now;
+            first = hdr.timestamp;
+            started = true;
+        }
+
+        timespecsub(&now, &start, &delta);
+        elapsed = timespec_to_usec(&delta);
+        if (hdr.timestamp - first > elapsed)
+            usleep(hdr.timestamp - first - elapsed);
+
+        greybus_rx_handler(hdr.cport, buffer, hdr.size);
+    }
+}
+
 int gb_tape_replay(const char *pathname)
 {
-    struct gb_tape_record_header hdr;
+    union {
+        uint32_t magic;
+        struct gb_tape_record_header hdr;
+    } start;
     char *buffer;
     ssize_t nread;
     int retval = 0;
@@ -1105,25 +2696,17 @@ int gb_tape_replay(const char *pathname)
         goto error_buffer_alloc;
     }
 
-    while (1) {
-        nread = gb_tape->read(fd, &hdr, sizeof(hdr));
-        if (!nread)
-            break;
-
-        if (nread != sizeof(hdr)) {
-            gb_error("gb-tape: invalid byte count read, aborting...\n");
-            retval = -EIO;
-            break;
-        }
-
-        nread = gb_tape->read(fd, buffer, hdr.size);
-        if (hdr.size != nread) {
-            gb_error("gb-tape: invalid byte count read, aborting...\n");
-            retval = -EIO;
-            break;
-        }
-
-        greybus_rx_handler(hdr.cport, buffer, nread);
+    /* Untimed tapes start directly with the header of the first record */
+    nread = gb_tape->read(fd, &start, sizeof(start));
+    if (!nread) {
+        retval = 0;
+    } else if (nread != sizeof(start)) {
+        gb_error("gb-tape: invalid byte count read, aborting...\n");
+        retval = -EIO;
+    } else if (start.magic == GB_TAPE_TIMED_MAGIC) {
+        retval = gb_tape_replay_timed(fd, buffer);
+    } else {
+        retval = gb_tape_replay_untimed(fd, buffer, &start.hdr);
     }
 
     free(buffer);
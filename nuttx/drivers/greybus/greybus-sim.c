@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2015 Motorola Mobility, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * In-process greybus transport for the simulation: cports 2n and 2n + 1 are
+ * connected back to back, so a driver registered on one end talks to the
+ * driver registered on the other end through the whole greybus core.
+ *
+ * Operation buffers are queued in place, without a copy, and delivered to
+ * greybus_rx_handler() by a dedicated thread, which stands for the RX
+ * interrupt of a real link.
+ */
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/list.h>
+#include <nuttx/greybus/debug.h>
+#include <nuttx/greybus/greybus.h>
+
+/*
+ * Messages given through send_async() carry this header in their headroom and
+ * are delivered in place. The ones given through send() are copied after it.
+ */
+struct gb_sim_msg {
+    struct list_head list;
+    unsigned int cport;
+    const void *buf;
+    size_t len;
+    gb_transport_send_done done;
+    void *priv;
+    uint8_t data[0];
+};
+
+static struct list_head gb_sim_queue;
+static sem_t gb_sim_sem;
+static pthread_t gb_sim_thread;
+static volatile bool gb_sim_exit;
+
+static void gb_sim_msg_release(struct gb_sim_msg *msg, int status)
+{
+    if (msg->done)
+        msg->done(status, msg->priv);
+    else
+        free(msg);
+}
+
+static void gb_sim_queue_msg(struct gb_sim_msg *msg)
+{
+    irqstate_t flags;
+
+    flags = irqsave();
+    list_add(&gb_sim_queue, &msg->list);
+    irqrestore(flags);
+
+    sem_post(&gb_sim_sem);
+}
+
+static void *gb_sim_rx_thread(void *data)
+{
+    struct gb_sim_msg *msg;
+    irqstate_t flags;
+    int retval;
+
+    while (1) {
+        retval = sem_wait(&gb_sim_sem);
+        if (retval < 0)
+            continue;
+
+        if (gb_sim_exit)
+            break;
+
+        flags = irqsave();
+        msg = list_entry(gb_sim_queue.next, struct gb_sim_msg, list);
+        list_del(&msg->list);
+        irqrestore(flags);
+
+        greybus_rx_handler(msg->cport ^ 1, (void *)msg->buf, msg->len);
+        gb_sim_msg_release(msg, 0);
+    }
+
+    return NULL;
+}
+
+static int gb_sim_send(unsigned int cport, const void *buf, size_t len)
+{
+    struct gb_sim_msg *msg;
+
+    msg = malloc(sizeof(*msg) + len);
+    if (!msg)
+        return -ENOMEM;
+
+    msg->cport = cport;
+    msg->buf = msg->data;
+    msg->len = len;
+    msg->done = NULL;
+    memcpy(msg->data, buf, len);
+
+    gb_sim_queue_msg(msg);
+    return 0;
+}
+
+static int gb_sim_send_async(unsigned int cport, const void *buf, size_t len,
+                             gb_transport_send_done done, void *priv)
+{
+    struct gb_sim_msg *msg =
+        (struct gb_sim_msg *)((char *)buf - sizeof(*msg));
+
+    msg->cport = cport;
+    msg->buf = buf;
+    msg->len = len;
+    msg->done = done;
+    msg->priv = priv;
+
+    gb_sim_queue_msg(msg);
+    return 0;
+}
+
+static int gb_sim_send_batch(const struct gb_transport_msg *msgs,
+                             size_t count)
+{
+    size_t i;
+    int retval;
+
+    for (i = 0; i < count; i++) {
+        retval = gb_sim_send(msgs[i].cport, msgs[i].buf, msgs[i].len);
+        if (retval)
+            return i ? i : retval;
+    }
+
+    return count;
+}
+
+static int gb_sim_listen(unsigned int cport)
+{
+    /* Nothing to do */
+    return 0;
+}
+
+static int gb_sim_stop_listening(unsigned int cport)
+{
+    /* Nothing to do */
+    return 0;
+}
+
+static void gb_sim_link_init(void)
+{
+    int retval;
+
+    list_init(&gb_sim_queue);
+    sem_init(&gb_sim_sem, 0, 0);
+    gb_sim_exit = false;
+
+    retval = pthread_create(&gb_sim_thread, NULL, gb_sim_rx_thread, NULL);
+    if (retval)
+        gb_error("cannot start the simulated link: error %d\n", retval);
+}
+
+static void gb_sim_link_exit(void)
+{
+    struct gb_sim_msg *msg;
+
+    gb_sim_exit = true;
+    sem_post(&gb_sim_sem);
+    pthread_join(gb_sim_thread, NULL);
+
+    while (!list_is_empty(&gb_sim_queue)) {
+        msg = list_entry(gb_sim_queue.next, struct gb_sim_msg, list);
+        list_del(&msg->list);
+        gb_sim_msg_release(msg, -ECONNRESET);
+    }
+
+    sem_destroy(&gb_sim_sem);
+}
+
+static struct gb_transport_backend gb_sim_backend = {
+    .headroom = sizeof(struct gb_sim_msg),
+    .init = gb_sim_link_init,
+    .exit = gb_sim_link_exit,
+    .send = gb_sim_send,
+    .send_batch = gb_sim_send_batch,
+    .send_async = gb_sim_send_async,
+    .listen = gb_sim_listen,
+    .stop_listening = gb_sim_stop_listening,
+    .alloc_buf = zalloc,
+    .free_buf = free,
+};
+
+int gb_sim_backend_init(void)
+{
+    return gb_init(&gb_sim_backend);
+}
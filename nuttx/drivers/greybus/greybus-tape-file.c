@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015 Motorola Mobility, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <nuttx/greybus/tape.h>
+
+static ssize_t gb_tape_write(int fd, const void *data, size_t size)
+{
+    ssize_t nwritten = write(fd, data, size);
+
+    return nwritten < 0 ? -errno : nwritten;
+}
+
+static ssize_t gb_tape_read(int fd, void *data, size_t size)
+{
+    ssize_t nread = read(fd, data, size);
+
+    return nread < 0 ? -errno : nread;
+}
+
+static int gb_tape_open(const char *tape, int mode)
+{
+    int flags;
+    int fd;
+
+    switch (mode) {
+    case GB_TAPE_RDONLY:
+        flags = O_RDONLY;
+        break;
+
+    case GB_TAPE_WRONLY:
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+        break;
+
+    default:
+        return -EINVAL;
+    }
+
+    fd = open(tape, flags, 0644);
+    return fd < 0 ? -errno : fd;
+}
+
+static void gb_tape_close(int fd)
+{
+    close(fd);
+}
+
+static struct gb_tape_mechanism gb_tape_file = {
+    .open = gb_tape_open,
+    .close = gb_tape_close,
+    .write = gb_tape_write,
+    .read = gb_tape_read,
+};
+
+int gb_tape_file_register(void)
+{
+    return gb_tape_register_mechanism(&gb_tape_file);
+}
@@ -43,6 +43,37 @@ static int gb_unipro_rx_handler(unsigned int cport, void *data, size_t size)
     return retval;
 }
 
+/*
+ * Stored in the headroom of every buffer, so that the greybus layer can give
+ * buffers to unipro_send_async() without allocating anything. The UniPro
+ * backend still allocates its own descriptor for every message.
+ */
+struct gb_unipro_tx {
+    gb_transport_send_done done;
+    void *priv;
+};
+
+static int gb_unipro_send_done(int status, const void *buf, void *priv)
+{
+    struct gb_unipro_tx *tx = priv;
+
+    tx->done(status, tx->priv);
+    return 0;
+}
+
+static int gb_unipro_send_async(unsigned int cport, const void *buf,
+                                size_t len, gb_transport_send_done done,
+                                void *priv)
+{
+    struct gb_unipro_tx *tx =
+        (struct gb_unipro_tx *)((char *)buf - sizeof(*tx));
+
+    tx->done = done;
+    tx->priv = priv;
+
+    return unipro_send_async(cport, buf, len, gb_unipro_send_done, tx);
+}
+
 static struct unipro_driver greybus_driver = {
     .name = "greybus",
     .rx_handler = gb_unipro_rx_handler,
@@ -59,8 +90,10 @@ static int gb_unipro_stop_listening(unsigned int cport)
 }
 
 const static struct gb_transport_backend gb_unipro_backend = {
+    .headroom = sizeof(struct gb_unipro_tx),
     .init = unipro_init,
     .send = unipro_send,
+    .send_async = gb_unipro_send_async,
     .listen = gb_unipro_listen,
     .stop_listening = gb_unipro_stop_listening,
     .alloc_buf = bufram_alloc,
@@ -123,6 +123,7 @@ static struct gb_loopback *loopback_from_cport(int cport)
 int gb_loopback_get_stats(int cport, struct gb_loopback_statistics *stats)
 {
     struct gb_loopback *loopback;
+    struct gb_dispatch_stats dispatch;
 
     loopback = loopback_from_cport(cport);
     if (!loopback) {
@@ -133,6 +134,13 @@ int gb_loopback_get_stats(int cport, struct gb_loopback_statistics *stats)
     memcpy(stats, &loopback->stats, sizeof(struct gb_loopback_statistics));
     loopback_unlock(loopback);
 
+    if (!gb_get_dispatch_stats(cport, &dispatch)) {
+        stats->dispatch_p50 = dispatch.latency_p50;
+        stats->dispatch_p90 = dispatch.latency_p90;
+        stats->dispatch_p99 = dispatch.latency_p99;
+        stats->stack_saved = dispatch.stack_saved;
+    }
+
     return 0;
 }
 
@@ -170,6 +178,7 @@ void gb_loopback_reset(int cport)
         loopback_lock(loopback);
         memset(&loopback->stats, 0, sizeof(struct gb_loopback_statistics));
         loopback_unlock(loopback);
+        gb_reset_dispatch_stats(cport);
     }
 }
 
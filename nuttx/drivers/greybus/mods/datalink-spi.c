@@ -937,9 +937,88 @@ err:
   return ret;
 }
 
+/* Caller must hold semaphore before calling this function! */
+static bool txp_has_room(FAR struct mods_spi_dl_s *priv, int packets)
+{
+  struct ring_buf *rb = priv->txp_rb;
+
+  while (packets-- > 0)
+    {
+      if (ring_buf_is_consumers(rb))
+          return false;
+
+      rb = ring_buf_get_next(rb);
+    }
+
+  return true;
+}
+
+/*
+ * Called by network layer when there are several messages to be sent to base.
+ * Each message still starts a new packet, since the base reassembles messages
+ * from the packet headers, but the whole batch is queued under a single lock
+ * and a single transfer is kicked off for it. The batch is rejected up front
+ * if the TX ring cannot hold all of it, so that no message is sent partially.
+ */
+static int queue_data_nw_batch(FAR struct mods_dl_s *dl,
+                               FAR const struct mods_dl_buf_s *bufs,
+                               size_t count)
+{
+  FAR struct mods_spi_dl_s *priv = (FAR struct mods_spi_dl_s *)dl;
+  size_t pl_size;
+  int packets = 0;
+  size_t i;
+  int ret;
+
+  do
+    {
+      ret = sem_wait(&priv->sem);
+    }
+  while (ret < 0 && errno == EINTR);
+
+  if (priv->bstate != BASE_ATTACHED)
+    {
+      ret = -ENODEV;
+      goto err;
+    }
+
+  pl_size = PL_SIZE(priv->pkt_size);
+  for (i = 0; i < count; i++)
+    {
+      if (bufs[i].len > MODS_DL_PAYLOAD_MAX_SZ)
+        {
+          ret = -E2BIG;
+          goto err;
+        }
+
+      packets += (bufs[i].len + pl_size - 1) / pl_size;
+    }
+
+  if (!txp_has_room(priv, packets))
+    {
+      dbg("Ring buffer cannot hold %d packets!\n", packets);
+      ret = -ENOMEM;
+      goto err;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      ret = queue_data(priv, MSG_TYPE_NW, bufs[i].buf, bufs[i].len);
+      DEBUGASSERT(ret == OK);
+    }
+
+  xfer(priv);
+
+err:
+  sem_post(&priv->sem);
+
+  return ret;
+}
+
 static struct mods_dl_ops_s mods_dl_ops =
 {
-  .send = queue_data_nw,
+  .send       = queue_data_nw,
+  .send_batch = queue_data_nw_batch,
 };
 
 static struct mods_spi_dl_s mods_spi_dl =
@@ -53,13 +53,43 @@
 
 #define MODS_DL_SEND(d,b,l) ((d)->ops->send(d,b,l))
 
+/****************************************************************************
+ * Name: MODS_DL_SEND_BATCH
+ *
+ * Description:
+ *   Send several buffers over physical layer to the base in one go. Either
+ *   all buffers are queued for transmission or none of them is. Optional,
+ *   MODS_DL_HAS_SEND_BATCH() must be checked before using it.
+ *
+ * Input Parameters:
+ *   dev   - Device-specific state data
+ *   bufs  - An array of buffers to be sent
+ *   count - The number of buffers in the array
+ *
+ * Returned Value:
+ *   0 on success, negative errno on failure.
+ *
+ ****************************************************************************/
+
+#define MODS_DL_HAS_SEND_BATCH(d) ((d)->ops->send_batch != NULL)
+#define MODS_DL_SEND_BATCH(d,b,c) ((d)->ops->send_batch(d,b,c))
+
 struct mods_dl_s;
 
+struct mods_dl_buf_s
+{
+  FAR const void *buf;
+  size_t len;
+};
+
 typedef int (*buf_t)(FAR struct mods_dl_s *dev, FAR const void *buf, size_t len);
+typedef int (*bufs_t)(FAR struct mods_dl_s *dev,
+                      FAR const struct mods_dl_buf_s *bufs, size_t count);
 
 struct mods_dl_ops_s
 {
   buf_t send;
+  bufs_t send_batch;
 };
 
 struct mods_dl_cb_s
@@ -82,6 +82,43 @@ static int network_send(unsigned int cport, const void *buf, size_t len)
   return MODS_DL_SEND(dl, m, len + sizeof(struct mods_msg_hdr));
 }
 
+static int network_send_batch(const struct gb_transport_msg *msgs,
+                              size_t count)
+{
+  struct mods_dl_buf_s bufs[GB_BATCH_MAX_OPS];
+  struct mods_msg *m;
+  size_t i;
+  int ret;
+
+  if (count > GB_BATCH_MAX_OPS)
+      return -E2BIG;
+
+  for (i = 0; i < count; i++)
+    {
+      m = (struct mods_msg *)((char *)msgs[i].buf -
+                              sizeof(struct mods_msg_hdr));
+      m->hdr.cport = cpu_to_le16(msgs[i].cport);
+
+      bufs[i].buf = m;
+      bufs[i].len = msgs[i].len + sizeof(struct mods_msg_hdr);
+    }
+
+  if (MODS_DL_HAS_SEND_BATCH(dl))
+    {
+      ret = MODS_DL_SEND_BATCH(dl, bufs, count);
+      return ret ? ret : count;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      ret = MODS_DL_SEND(dl, bufs[i].buf, bufs[i].len);
+      if (ret)
+          return i ? i : ret;
+    }
+
+  return count;
+}
+
 static int network_listen(unsigned int cport)
 {
   /* Nothing to do */
@@ -99,6 +136,7 @@ const static struct gb_transport_backend mods_network =
   .headroom = (sizeof(struct mods_msg_hdr) + 3) & ~0x0003,
   .init = network_init,
   .send = network_send,
+  .send_batch = network_send_batch,
   .listen = network_listen,
   .stop_listening = network_stop_listening,
   .alloc_buf = zalloc,
@@ -26,6 +26,8 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <nuttx/config.h>
+
 #include <assert.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -40,10 +42,11 @@
 #define BITS_PER_LEVEL  4
 #define LEVEL_MASK     ((1 << BITS_PER_LEVEL) - 1)
 #define TOTAL_BITS     16
-#define TABLE_ENTRIES  16 /* 2 ^ BITS_PER_LEVEL */
+#define TABLE_ENTRIES  RTR_TABLE_ENTRIES /* 2 ^ BITS_PER_LEVEL */
 
 #define LEVELS (TOTAL_BITS / BITS_PER_LEVEL)
 #define TABLE_SIZE (TABLE_ENTRIES * sizeof(void *))
+#define FLAT_SIZE (CONFIG_GREYBUS_RTR_FLAT_ENTRIES * sizeof(void *))
 
 #define SUB_TABLE(a, lvl) ((a >> (lvl * BITS_PER_LEVEL)) & LEVEL_MASK)
 
@@ -56,9 +59,9 @@ static inline void **_rtr_get_parent(void *tbl[])
     return tbl[-HDR_ENTRIES];
 }
 
-static void *_rtr_alloc_table(void *parent[])
+static void *_rtr_alloc_table(void *parent[], size_t size)
 {
-    void **child = zalloc(TABLE_SIZE + HDR_SIZE);
+    void **child = zalloc(size + HDR_SIZE);
     void *rv;
 
     child[0] = parent;
@@ -69,7 +72,7 @@ static void *_rtr_alloc_table(void *parent[])
 
 void *rtr_alloc_table(void)
 {
-    return _rtr_alloc_table(NULL);
+    return _rtr_alloc_table(NULL, TABLE_SIZE + FLAT_SIZE);
 }
 
 static void _rtr_free_table(void *tbl[])
@@ -91,7 +94,7 @@ static void _add_value(void *tbl[], uint16_t a, int lvl, void *data)
             tbl[a3] = data;
     } else {
         if (tbl[a3] == NULL) {
-            tbl[a3] = _rtr_alloc_table(tbl);
+            tbl[a3] = _rtr_alloc_table(tbl, TABLE_SIZE);
         }
         _add_value(tbl[a3], a, lvl - 1, data);
     }
@@ -101,6 +104,10 @@ void rtr_add_value(void *tbl[], uint16_t a, void *data)
 {
     gb_debug("%s(%p, 0x%04x, %p)\n", __func__, tbl, a, data);
     _add_value(tbl, a, LEVELS - 1, data);
+
+    /* the tree is still kept up to date for the rtr_get_*_value() walks */
+    if (a < CONFIG_GREYBUS_RTR_FLAT_ENTRIES)
+        RTR_FLAT_TBL(tbl)[a] = data;
 }
 
 static void _remove_value(void *tbl[], uint16_t a, int lvl)
@@ -134,6 +141,9 @@ static void _remove_value(void *tbl[], uint16_t a, int lvl)
 void rtr_remove_value(void *tbl[], uint16_t a)
 {
     gb_debug("%s(%p, 0x%04x)\n", __func__, tbl, a);
+    if (a < CONFIG_GREYBUS_RTR_FLAT_ENTRIES)
+        RTR_FLAT_TBL(tbl)[a] = NULL;
+
     _remove_value(tbl, a, LEVELS - 1);
 }
 
@@ -162,7 +172,7 @@ static void **_get_value(void *tbl[], int lvl, uint16_t a, uint16_t *ndx)
     }
 }
 
-void *rtr_get_value(void *tbl[], uint16_t a)
+void *rtr_get_tree_value(void *tbl[], uint16_t a)
 {
     uint16_t ndx;
     void **l0_tbl;
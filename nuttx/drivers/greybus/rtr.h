@@ -29,11 +29,35 @@
 #ifndef _RTR_H__
 #define _RTR_H__
 
+#ifndef CONFIG_GREYBUS_RTR_FLAT_ENTRIES
+#  define CONFIG_GREYBUS_RTR_FLAT_ENTRIES 64
+#endif
+
+/* Number of entries in each level of the radix tree */
+#define RTR_TABLE_ENTRIES 16
+
+/*
+ * The top level table is followed by a flat array mirroring the values of the
+ * first CONFIG_GREYBUS_RTR_FLAT_ENTRIES addresses, so that the usual dense
+ * low range is resolved without walking the tree.
+ */
+#define RTR_FLAT_TBL(tbl) (&(tbl)[RTR_TABLE_ENTRIES])
+
 void *rtr_alloc_table(void);
 void rtr_free_table(void *tbl);
 void rtr_add_value(void *tbl[], uint16_t a, void *data);
 void rtr_remove_value(void *tbl[], uint16_t a);
-void *rtr_get_value(void *tbl[], uint16_t a);
+void *rtr_get_tree_value(void *tbl[], uint16_t a);
+
+static inline void *rtr_get_value(void *tbl[], uint16_t a)
+{
+#if CONFIG_GREYBUS_RTR_FLAT_ENTRIES > 0
+    if (a < CONFIG_GREYBUS_RTR_FLAT_ENTRIES)
+        return RTR_FLAT_TBL(tbl)[a];
+#endif
+
+    return rtr_get_tree_value(tbl, a);
+}
 
 void *rtr_get_first_value(void *tbl);
 void *rtr_get_next_value(void *tbl, uint16_t last_value);
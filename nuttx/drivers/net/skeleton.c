@@ -76,6 +76,14 @@
 
 #define skeleton_TXTIMEOUT (60*CLK_TCK)
 
+/* With descriptor rings, the number of TX and RX descriptors (powers of two) */
+
+#ifdef CONFIG_NET_RINGS
+#  define skeleton_NTXDESC 4
+#  define skeleton_NRXDESC 4
+#  define skeleton_BUFSIZE (CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE)
+#endif
+
 /* This is a helper pointer for accessing the contents of the Ethernet header */
 
 #define BUF ((struct eth_hdr_s *)skel->sk_dev.d_buf)
@@ -94,6 +102,20 @@ struct skel_driver_s
   WDOG_ID sk_txpoll;           /* TX poll timer */
   WDOG_ID sk_txtimeout;        /* TX timeout timer */
 
+#ifdef CONFIG_NET_RINGS
+  /* Descriptor rings.  The frames from the tail of sk_txring up to
+   * sk_txsent have been given to the hardware, those from sk_txsent up to
+   * the head are waiting to be.
+   */
+
+  uint8_t sk_txsent;           /* Next TX frame to give to the hardware */
+  struct netdev_ring_s sk_txring;
+  struct netdev_ring_s sk_rxring;
+  struct netdev_desc_s sk_txdesc[skeleton_NTXDESC];
+  struct netdev_desc_s sk_rxdesc[skeleton_NRXDESC];
+  uint8_t sk_buffers[skeleton_NTXDESC + skeleton_NRXDESC][skeleton_BUFSIZE];
+#endif
+
   /* This holds the information visible to uIP/NuttX */
 
   struct net_driver_s sk_dev;  /* Interface understood by uIP */
@@ -113,9 +135,13 @@ static struct skel_driver_s g_skel[CONFIG_skeleton_NINTERFACES];
 
 static int  skel_transmit(FAR struct skel_driver_s *skel);
 static int  skel_txpoll(struct net_driver_s *dev);
+static void skel_poll(FAR struct skel_driver_s *skel, int hsec);
 
 /* Interrupt handling */
 
+#ifdef CONFIG_NET_RINGS
+static int  skel_input(struct net_driver_s *dev);
+#endif
 static void skel_receive(FAR struct skel_driver_s *skel);
 static void skel_txdone(FAR struct skel_driver_s *skel);
 static int  skel_interrupt(int irq, FAR void *context);
@@ -159,6 +185,38 @@ static int skel_rmmac(struct net_driver_s *dev, FAR const uint8_t *mac);
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_RINGS
+static int skel_transmit(FAR struct skel_driver_s *skel)
+{
+  FAR struct netdev_desc_s *desc;
+
+  /* Give all of the waiting frames to the hardware */
+
+  if (skel->sk_txsent == skel->sk_txring.nr_head)
+    {
+      return OK;
+    }
+
+  do
+    {
+      desc = NETDEV_RING_DESC(&skel->sk_txring, skel->sk_txsent);
+
+      /* Increment statistics */
+
+      /* Queue the packet: address=desc->nd_buf, length=desc->nd_len */
+
+      skel->sk_txsent++;
+    }
+  while (skel->sk_txsent != skel->sk_txring.nr_head);
+
+  /* Enable Tx interrupts */
+
+  /* Setup the TX timeout watchdog (perhaps restarting the timer) */
+
+  (void)wd_start(skel->sk_txtimeout, skeleton_TXTIMEOUT, skel_txtimeout, 1, (uint32_t)skel);
+  return OK;
+}
+#else
 static int skel_transmit(FAR struct skel_driver_s *skel)
 {
   /* Verify that the hardware is ready to send another packet.  If we get
@@ -177,6 +235,7 @@ static int skel_transmit(FAR struct skel_driver_s *skel)
   (void)wd_start(skel->sk_txtimeout, skeleton_TXTIMEOUT, skel_txtimeout, 1, (uint32_t)skel);
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Function: skel_txpoll
@@ -213,11 +272,18 @@ static int skel_txpoll(struct net_driver_s *dev)
   if (skel->sk_dev.d_len > 0)
     {
       arp_out(&skel->sk_dev);
+
+      /* With descriptor rings, the packet is queued in the TX ring and the
+       * poll stops by itself when the ring is full.
+       */
+
+#ifndef CONFIG_NET_RINGS
       skel_transmit(skel);
 
       /* Check if there is room in the device to hold another packet. If not,
        * return a non-zero value to terminate the poll.
        */
+#endif
     }
 
   /* If zero is returned, the polling will continue until all connections have
@@ -227,6 +293,109 @@ static int skel_txpoll(struct net_driver_s *dev)
   return 0;
 }
 
+/****************************************************************************
+ * Function: skel_poll
+ *
+ * Description:
+ *   Poll uIP for new XMIT data, performing the TCP timer actions too if hsec
+ *   is non-zero.  With descriptor rings, as many packets are queued as there
+ *   are free TX descriptors, and then given to the hardware.
+ *
+ * Parameters:
+ *   skel  - Reference to the driver state structure
+ *   hsec  - Time elapsed since the last timer poll, in half-seconds, or zero
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Global interrupts are disabled, either explicitly or indirectly through
+ *   interrupt handling logic.
+ *
+ ****************************************************************************/
+
+static void skel_poll(FAR struct skel_driver_s *skel, int hsec)
+{
+#ifdef CONFIG_NET_RINGS
+  if (hsec > 0)
+    {
+      (void)devif_ring_timer(&skel->sk_dev, &skel->sk_txring, skel_txpoll, hsec);
+    }
+  else
+    {
+      (void)devif_ring_poll(&skel->sk_dev, &skel->sk_txring, skel_txpoll);
+    }
+
+  (void)skel_transmit(skel);
+#else
+  if (hsec > 0)
+    {
+      (void)devif_timer(&skel->sk_dev, skel_txpoll, hsec);
+    }
+  else
+    {
+      (void)devif_poll(&skel->sk_dev, skel_txpoll);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Function: skel_input
+ *
+ * Description:
+ *   With descriptor rings, process one of the received packets.  This is a
+ *   callback from devif_ring_input().
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Always zero
+ *
+ * Assumptions:
+ *   Global interrupts are disabled by interrupt handling logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RINGS
+static int skel_input(struct net_driver_s *dev)
+{
+  FAR struct skel_driver_s *skel = (FAR struct skel_driver_s *)dev->d_private;
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv6
+  if (BUF->type == HTONS(ETHTYPE_IP6))
+#else
+  if (BUF->type == HTONS(ETHTYPE_IP))
+#endif
+    {
+      arp_ipin(&skel->sk_dev);
+      devif_input(&skel->sk_dev);
+
+      /* If the above function invocation resulted in data that should be
+       * sent out on the network, the field  d_len will set to a value > 0.
+       * devif_ring_input() then queues it in the TX ring.
+       */
+
+      if (skel->sk_dev.d_len > 0)
+        {
+          arp_out(&skel->sk_dev);
+        }
+    }
+  else if (BUF->type == htons(ETHTYPE_ARP))
+    {
+      arp_arpin(&skel->sk_dev);
+    }
+  else
+    {
+      skel->sk_dev.d_len = 0;
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Function: skel_receive
  *
@@ -244,6 +413,40 @@ static int skel_txpoll(struct net_driver_s *dev)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_RINGS
+static void skel_receive(FAR struct skel_driver_s *skel)
+{
+  FAR struct netdev_desc_s *desc;
+
+  /* Take as many of the received packets as there are free RX descriptors */
+
+  while (!NETDEV_RING_FULL(&skel->sk_rxring))
+    {
+      /* Stop if there are no more packets to be processed */
+
+      desc = NETDEV_RING_HEAD(&skel->sk_rxring);
+
+      /* Check for errors and update statistics */
+
+      /* Check if the packet is a valid size for the uIP buffer configuration */
+
+      /* Copy the data data from the hardware to desc->nd_buf, or swap
+       * desc->nd_buf with the buffer filled by the hardware.  Set amount of
+       * data in desc->nd_len
+       */
+
+      skel->sk_rxring.nr_head++;
+    }
+
+  /* Then process the whole burst and send the replies, as well as any new
+   * XMIT data.
+   */
+
+  (void)devif_ring_input(&skel->sk_dev, &skel->sk_rxring, &skel->sk_txring,
+                         skel_input);
+  skel_poll(skel, 0);
+}
+#else
 static void skel_receive(FAR struct skel_driver_s *skel)
 {
   do
@@ -293,6 +496,7 @@ static void skel_receive(FAR struct skel_driver_s *skel)
     }
   while (); /* While there are more packets to be processed */
 }
+#endif
 
 /****************************************************************************
  * Function: skel_txdone
@@ -315,6 +519,17 @@ static void skel_txdone(FAR struct skel_driver_s *skel)
 {
   /* Check for errors and update statistics */
 
+#ifdef CONFIG_NET_RINGS
+  /* Free the TX descriptors of the packets sent */
+
+  while (skel->sk_txring.nr_tail != skel->sk_txsent)
+    {
+      /* Stop at the first packet that the hardware has not sent yet */
+
+      skel->sk_txring.nr_tail++;
+    }
+#endif
+
   /* If no further xmits are pending, then cancel the TX timeout and
    * disable further Tx interrupts.
    */
@@ -323,7 +538,7 @@ static void skel_txdone(FAR struct skel_driver_s *skel)
 
   /* Then poll uIP for new XMIT data */
 
-  (void)devif_poll(&skel->sk_dev, skel_txpoll);
+  skel_poll(skel, 0);
 }
 
 /****************************************************************************
@@ -392,9 +607,15 @@ static void skel_txtimeout(int argc, uint32_t arg, ...)
 
   /* Then reset the hardware */
 
+#ifdef CONFIG_NET_RINGS
+  /* The packets given to the hardware were lost, give them again */
+
+  skel->sk_txsent = skel->sk_txring.nr_tail;
+#endif
+
   /* Then poll uIP for new XMIT data */
 
-  (void)devif_poll(&skel->sk_dev, skel_txpoll);
+  skel_poll(skel, 0);
 }
 
 /****************************************************************************
@@ -428,7 +649,7 @@ static void skel_polltimer(int argc, uint32_t arg, ...)
    * we will missing TCP time state updates?
    */
 
-  (void)devif_timer(&skel->sk_dev, skel_txpoll, skeleton_POLLHSEC);
+  skel_poll(skel, skeleton_POLLHSEC);
 
   /* Setup the watchdog poll timer again */
 
@@ -554,7 +775,7 @@ static int skel_txavail(struct net_driver_s *dev)
 
       /* If so, then poll uIP for new XMIT data */
 
-      (void)devif_poll(&skel->sk_dev, skel_txpoll);
+      skel_poll(skel, 0);
     }
 
   irqrestore(flags);
@@ -643,6 +864,9 @@ static int skel_rmmac(struct net_driver_s *dev, FAR const uint8_t *mac)
 int skel_initialize(int intf)
 {
   struct skel_driver_s *priv;
+#ifdef CONFIG_NET_RINGS
+  int i;
+#endif
 
   /* Get the interface structure associated with this interface number. */
 
@@ -672,6 +896,26 @@ int skel_initialize(int intf)
 #endif
   priv->sk_dev.d_private = (void*)g_skel; /* Used to recover private state from dev */
 
+#ifdef CONFIG_NET_RINGS
+  /* Set up the descriptor rings */
+
+  for (i = 0; i < skeleton_NTXDESC; i++)
+    {
+      priv->sk_txdesc[i].nd_buf = priv->sk_buffers[i];
+    }
+
+  for (i = 0; i < skeleton_NRXDESC; i++)
+    {
+      priv->sk_rxdesc[i].nd_buf = priv->sk_buffers[skeleton_NTXDESC + i];
+    }
+
+  priv->sk_txring.nr_desc = priv->sk_txdesc;
+  priv->sk_txring.nr_size = skeleton_NTXDESC;
+  priv->sk_rxring.nr_desc = priv->sk_rxdesc;
+  priv->sk_rxring.nr_size = skeleton_NRXDESC;
+  priv->sk_dev.d_buf      = priv->sk_buffers[skeleton_NTXDESC];
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmisstions */
 
   priv->sk_txpoll       = wd_create();   /* Create periodic poll timer */
@@ -83,6 +83,17 @@
 
 #define VNET_TXTIMEOUT (60*CLK_TCK)
 
+/* With descriptor rings, the number of TX descriptors (a power of two).
+ * rgmp hands over the received packets one at a time, so a single RX
+ * descriptor is enough.
+ */
+
+#ifdef CONFIG_NET_RINGS
+#  define VNET_NTXDESC  4
+#  define VNET_NRXDESC  1
+#  define VNET_BUFSIZE  (CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE)
+#endif
+
 /* This is a helper pointer for accessing the contents of the Ethernet header */
 
 #define BUF ((struct eth_hdr_s *)vnet->sk_dev.d_buf)
@@ -101,6 +112,18 @@ struct vnet_driver_s
     WDOG_ID sk_txpoll;           /* TX poll timer */
     //WDOG_ID sk_txtimeout;        /* TX timeout timer */
 
+#ifdef CONFIG_NET_RINGS
+	/* Descriptor rings.  The packets queued in sk_txring are handed to
+	 * vnet_xmit() until the TX buffer of the host is full.
+	 */
+
+	struct netdev_ring_s sk_txring;
+	struct netdev_ring_s sk_rxring;
+	struct netdev_desc_s sk_txdesc[VNET_NTXDESC];
+	struct netdev_desc_s sk_rxdesc[VNET_NRXDESC];
+	uint8_t sk_buffers[VNET_NTXDESC + VNET_NRXDESC][VNET_BUFSIZE];
+#endif
+
     /* This holds the information visible to uIP/NuttX */
     struct rgmp_vnet *vnet;
     struct net_driver_s sk_dev;  /* Interface understood by uIP */
@@ -118,12 +141,21 @@ static struct vnet_driver_s g_vnet[CONFIG_VNET_NINTERFACES];
 
 /* Common TX logic */
 
+#ifdef CONFIG_NET_RINGS
+static void vnet_flush(FAR struct vnet_driver_s *vnet);
+#else
 static int  vnet_transmit(FAR struct vnet_driver_s *vnet);
+#endif
 static int  vnet_txpoll(struct net_driver_s *dev);
+static void vnet_poll(FAR struct vnet_driver_s *vnet, int hsec);
 
 /* Interrupt handling */
 
+#ifdef CONFIG_NET_RINGS
+static int  vnet_input(struct net_driver_s *dev);
+#else
 static void vnet_txdone(FAR struct vnet_driver_s *vnet);
+#endif
 
 /* Watchdog timer expirations */
 
@@ -144,6 +176,41 @@ static int vnet_rmmac(struct net_driver_s *dev, FAR const uint8_t *mac);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: vnet_flush
+ *
+ * Description:
+ *   With descriptor rings, hand the packets queued in the TX ring to the
+ *   host, until its TX buffer is full.  The packets left stay queued for
+ *   the next poll.
+ *
+ * Parameters:
+ *   vnet  - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Global interrupts are disabled, either explicitly or indirectly through
+ *   interrupt handling logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RINGS
+static void vnet_flush(FAR struct vnet_driver_s *vnet)
+{
+	FAR struct netdev_desc_s *desc;
+
+	while (!NETDEV_RING_EMPTY(&vnet->sk_txring)) {
+		desc = NETDEV_RING_TAIL(&vnet->sk_txring);
+		if (vnet_xmit(vnet->vnet, (char *)desc->nd_buf, desc->nd_len))
+			break;
+
+		vnet->sk_txring.nr_tail++;
+	}
+}
+#endif
+
 /****************************************************************************
  * Function: vnet_transmit
  *
@@ -164,6 +231,7 @@ static int vnet_rmmac(struct net_driver_s *dev, FAR const uint8_t *mac);
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_RINGS
 static int vnet_transmit(FAR struct vnet_driver_s *vnet)
 {
     int err;
@@ -196,6 +264,7 @@ static int vnet_transmit(FAR struct vnet_driver_s *vnet)
 
     return OK;
 }
+#endif
 
 /****************************************************************************
  * Function: vnet_txpoll
@@ -232,6 +301,11 @@ static int vnet_txpoll(struct net_driver_s *dev)
 	if (vnet->sk_dev.d_len > 0)
     {
 		arp_out(&vnet->sk_dev);
+
+		/* With descriptor rings, the packet is queued in the TX ring and the
+		 * poll stops by itself when the ring is full.
+		 */
+#ifndef CONFIG_NET_RINGS
 		vnet_transmit(vnet);
 
 		/* Check if there is room in the device to hold another packet. If not,
@@ -239,6 +313,7 @@ static int vnet_txpoll(struct net_driver_s *dev)
 		 */
 		if (vnet_is_txbuff_full(vnet->vnet))
 			return 1;
+#endif
     }
 
 	/* If zero is returned, the polling will continue until all connections have
@@ -248,6 +323,99 @@ static int vnet_txpoll(struct net_driver_s *dev)
 	return 0;
 }
 
+/****************************************************************************
+ * Function: vnet_poll
+ *
+ * Description:
+ *   Poll uIP for new XMIT data, performing the TCP timer actions too if hsec
+ *   is non-zero.  With descriptor rings, as many packets are queued as there
+ *   are free TX descriptors, and then handed to the host.
+ *
+ * Parameters:
+ *   vnet  - Reference to the driver state structure
+ *   hsec  - Time elapsed since the last timer poll, in half-seconds, or zero
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Global interrupts are disabled, either explicitly or indirectly through
+ *   interrupt handling logic.
+ *
+ ****************************************************************************/
+
+static void vnet_poll(FAR struct vnet_driver_s *vnet, int hsec)
+{
+#ifdef CONFIG_NET_RINGS
+	/* Make room for new packets first */
+
+	vnet_flush(vnet);
+
+	if (hsec > 0)
+		(void)devif_ring_timer(&vnet->sk_dev, &vnet->sk_txring, vnet_txpoll, hsec);
+	else
+		(void)devif_ring_poll(&vnet->sk_dev, &vnet->sk_txring, vnet_txpoll);
+
+	vnet_flush(vnet);
+#else
+	if (hsec > 0)
+		(void)devif_timer(&vnet->sk_dev, vnet_txpoll, hsec);
+	else
+		(void)devif_poll(&vnet->sk_dev, vnet_txpoll);
+#endif
+}
+
+/****************************************************************************
+ * Function: vnet_input
+ *
+ * Description:
+ *   With descriptor rings, process the received packet.  This is a callback
+ *   from devif_ring_input().
+ *
+ * Parameters:
+ *   dev  - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Always zero
+ *
+ * Assumptions:
+ *   Global interrupts are disabled by interrupt handling logic.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RINGS
+static int vnet_input(struct net_driver_s *dev)
+{
+	FAR struct vnet_driver_s *vnet = (FAR struct vnet_driver_s *)dev->d_private;
+
+	/* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv6
+	if (BUF->type == HTONS(ETHTYPE_IP6))
+#else
+	if (BUF->type == HTONS(ETHTYPE_IP))
+#endif
+	{
+		arp_ipin(&vnet->sk_dev);
+		devif_input(&vnet->sk_dev);
+
+		// If the above function invocation resulted in data that should be
+		// sent out on the network, the field  d_len will set to a value > 0.
+		// devif_ring_input() then queues it in the TX ring.
+		if (vnet->sk_dev.d_len > 0)
+			arp_out(&vnet->sk_dev);
+	}
+	else if (BUF->type == htons(ETHTYPE_ARP)) {
+		arp_arpin(&vnet->sk_dev);
+	}
+	else {
+		vnet->sk_dev.d_len = 0;
+	}
+
+	return 0;
+}
+#endif
+
 /****************************************************************************
  * Function: rtos_vnet_recv
  *
@@ -265,6 +433,32 @@ static int vnet_txpoll(struct net_driver_s *dev)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_RINGS
+void rtos_vnet_recv(struct rgmp_vnet *rgmp_vnet, char *data, int len)
+{
+	struct vnet_driver_s *vnet = rgmp_vnet->priv;
+	FAR struct netdev_desc_s *desc;
+
+	/* Check if the packet is a valid size for the uIP buffer configuration */
+	if (len > CONFIG_NET_BUFSIZE || len < 14) {
+#ifdef CONFIG_DEBUG
+		cprintf("VNET: receive invalid packet of size %d\n", len);
+#endif
+		return;
+	}
+
+	// Copy the data to the RX descriptor, then process it and send the reply
+	// and any new XMIT data together.
+	desc = NETDEV_RING_HEAD(&vnet->sk_rxring);
+	memcpy(desc->nd_buf, data, len);
+	desc->nd_len = len;
+	vnet->sk_rxring.nr_head++;
+
+	(void)devif_ring_input(&vnet->sk_dev, &vnet->sk_rxring, &vnet->sk_txring,
+						   vnet_input);
+	vnet_poll(vnet, 0);
+}
+#else
 void rtos_vnet_recv(struct rgmp_vnet *rgmp_vnet, char *data, int len)
 {
     struct vnet_driver_s *vnet = rgmp_vnet->priv;
@@ -315,6 +509,7 @@ void rtos_vnet_recv(struct rgmp_vnet *rgmp_vnet, char *data, int len)
     }
     while (0); /* While there are more packets to be processed */
 }
+#endif
 
 /****************************************************************************
  * Function: vnet_txdone
@@ -333,6 +528,7 @@ void rtos_vnet_recv(struct rgmp_vnet *rgmp_vnet, char *data, int len)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_RINGS
 static void vnet_txdone(FAR struct vnet_driver_s *vnet)
 {
 	/* Check for errors and update statistics */
@@ -347,6 +543,7 @@ static void vnet_txdone(FAR struct vnet_driver_s *vnet)
 
 	(void)devif_poll(&vnet->sk_dev, vnet_txpoll);
 }
+#endif
 
 /****************************************************************************
  * Function: vnet_txtimeout
@@ -377,7 +574,7 @@ static void vnet_txtimeout(int argc, uint32_t arg, ...)
 
 	/* Then poll uIP for new XMIT data */
 
-	(void)devif_poll(&vnet->sk_dev, vnet_txpoll);
+	vnet_poll(vnet, 0);
 }
 
 /****************************************************************************
@@ -417,7 +614,7 @@ static void vnet_polltimer(int argc, uint32_t arg, ...)
 	 * we will missing TCP time state updates?
 	 */
 
-	(void)devif_timer(&vnet->sk_dev, vnet_txpoll, VNET_POLLHSEC);
+	vnet_poll(vnet, VNET_POLLHSEC);
 
 	/* Setup the watchdog poll timer again */
 
@@ -545,7 +742,7 @@ static int vnet_txavail(struct net_driver_s *dev)
 
 		/* If so, then poll uIP for new XMIT data */
 
-		(void)devif_poll(&vnet->sk_dev, vnet_txpoll);
+		vnet_poll(vnet, 0);
     }
 
 out:
@@ -636,6 +833,9 @@ int vnet_init(struct rgmp_vnet *vnet)
 {
 	struct vnet_driver_s *priv;
 	static int i = 0;
+#ifdef CONFIG_NET_RINGS
+	int j;
+#endif
 
 	if (i >= CONFIG_VNET_NINTERFACES)
 		return -1;
@@ -654,6 +854,22 @@ int vnet_init(struct rgmp_vnet *vnet)
 #endif
 	priv->sk_dev.d_private = (void*)priv;   /* Used to recover private state from dev */
 
+#ifdef CONFIG_NET_RINGS
+	/* Set up the descriptor rings */
+
+	for (j = 0; j < VNET_NTXDESC; j++)
+		priv->sk_txdesc[j].nd_buf = priv->sk_buffers[j];
+
+	for (j = 0; j < VNET_NRXDESC; j++)
+		priv->sk_rxdesc[j].nd_buf = priv->sk_buffers[VNET_NTXDESC + j];
+
+	priv->sk_txring.nr_desc = priv->sk_txdesc;
+	priv->sk_txring.nr_size = VNET_NTXDESC;
+	priv->sk_rxring.nr_desc = priv->sk_rxdesc;
+	priv->sk_rxring.nr_size = VNET_NRXDESC;
+	priv->sk_dev.d_buf      = priv->sk_buffers[VNET_NTXDESC];
+#endif
+
 	/* Create a watchdog for timing polling for and timing of transmisstions */
 
 	priv->sk_txpoll       = wd_create();    /* Create periodic poll timer */
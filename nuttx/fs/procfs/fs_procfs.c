@@ -77,7 +77,9 @@
 
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations irqs_operations;
 extern const struct procfs_operations uptime_operations;
+extern const struct procfs_operations heap_operations;
 
 /* This is not good.  These are implemented in drivers/mtd.  Having to
  * deal with them here is not a good coupling.
@@ -87,6 +89,10 @@ extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
 
+/* Likewise, implemented in mm/bufram */
+
+extern const struct procfs_operations bufram_procfsoperations;
+
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
  * operations table with a RAM-base registration table.
@@ -112,6 +118,23 @@ static const struct procfs_entry_s g_procfsentries[] =
   { "cpuload",          &cpuload_operations },
 #endif
 
+#if defined(CONFIG_SCHED_SCHEDSTAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IRQS)
+  { "irqs",             &irqs_operations },
+#endif
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP) && \
+    (!defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_MM_KERNEL_HEAP))
+  { "heap/frag",        &heap_operations },
+#ifdef CONFIG_MM_TRACE
+  { "heap/sites",       &heap_operations },
+  { "heap/trace",       &heap_operations },
+#endif
+#endif
+
+#if defined(CONFIG_MM_BUFRAM_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BUFRAM)
+  { "bufram",           &bufram_procfsoperations },
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 //{ "fs/smartfs",       &smartfs_procfsoperations },
   { "fs/smartfs**",     &smartfs_procfsoperations },
@@ -725,7 +748,8 @@ static int procfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
        * subdirectory are listed in order in the procfs_entry array.
        */
 
-      if (strncmp(g_procfsentries[level1->base.index].pathpattern,
+      if (level1->base.index < g_procfsentrycount &&
+          strncmp(g_procfsentries[level1->base.index].pathpattern,
               g_procfsentries[level1->firstindex].pathpattern,
               level1->subdirlen) == 0)
         {
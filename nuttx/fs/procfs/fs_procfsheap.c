@@ -0,0 +1,781 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheap.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP) && \
+    (!defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_MM_KERNEL_HEAP))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAP_LINELEN 80
+
+/* The heap reported:  the kernel heap if there is one, the user heap
+ * otherwise.
+ */
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+#  define HEAP_HEAP (&g_kmmheap)
+#else
+#  define HEAP_HEAP (&g_mmheap)
+#endif
+
+/* The free chunks are counted in power-of-two size ranges, the last range
+ * holding all of the chunks of MM_MAX_CHUNK and above.
+ */
+
+#define HEAP_NBUCKETS MM_NNODES
+
+#ifdef CONFIG_MM_TRACE
+/* The live allocations are grouped by call site in a hash table.  The
+ * allocations from the call sites that do not fit in the table are
+ * counted in an additional, last entry.
+ */
+
+#  define HEAP_NSITES CONFIG_MM_TRACE_NSITES
+#  define HEAP_NEVENTS CONFIG_MM_TRACE_NEVENTS
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The files of the heap directory */
+
+enum heap_node_e
+{
+  HEAP_FRAG = 0,                /* Histogram of the free chunks */
+#ifdef CONFIG_MM_TRACE
+  HEAP_SITES,                   /* Live allocations by call site */
+  HEAP_TRACE                    /* Ring of allocation events */
+#endif
+};
+
+/* Snapshot of the free chunks */
+
+struct heap_frag_s
+{
+  size_t arena;                 /* Size of the heap */
+  size_t largest;               /* Largest free chunk */
+  size_t nfree[HEAP_NBUCKETS];  /* Number of free chunks by size range */
+  size_t free[HEAP_NBUCKETS];   /* Free memory by size range */
+#ifdef CONFIG_MM_CACHE
+  struct mm_cacheinfo_s cache;  /* Small-object cache statistics */
+#endif
+};
+
+#ifdef CONFIG_MM_TRACE
+/* Snapshot of the live allocations of one call site */
+
+struct heap_site_s
+{
+  FAR void *caller;             /* Call site, NULL for the last entry */
+  size_t count;                 /* Number of live allocations */
+  size_t bytes;                 /* Memory used, chunk overhead included */
+  uint16_t age;                 /* Age of the oldest one, in seconds */
+};
+
+/* State of the call site grouping walk */
+
+struct heap_sitewalk_s
+{
+  FAR struct heap_site_s *sites;
+  uint16_t now;
+};
+#endif
+
+/* This structure describes one open "file".  The snapshot taken when
+ * opening the file follows it in the same allocation.
+ */
+
+struct heap_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  uint8_t node;                 /* Type of file (see enum heap_node_e) */
+  int nitems;                   /* Number of items in the snapshot */
+  size_t allocsize;             /* Size of this structure and snapshot */
+  char line[HEAP_LINELEN];      /* Pre-allocated buffer for formatted lines */
+  union
+  {
+    struct heap_frag_s frag;
+#ifdef CONFIG_MM_TRACE
+    struct heap_site_s sites[HEAP_NSITES + 1];
+    struct mm_traceevent_s events[HEAP_NEVENTS];
+#endif
+  } u;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heap_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heap_close(FAR struct file *filep);
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heap_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heap_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The names of the files, indexed by enum heap_node_e */
+
+static FAR const char * const g_heapnodes[] =
+{
+  "heap/frag",
+#ifdef CONFIG_MM_TRACE
+  "heap/sites",
+  "heap/trace"
+#endif
+};
+
+#define HEAP_NNODES (sizeof(g_heapnodes) / sizeof(g_heapnodes[0]))
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heap_operations =
+{
+  heap_open,          /* open */
+  heap_close,         /* close */
+  heap_read,          /* read */
+  NULL,               /* write */
+
+  heap_dup,           /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  heap_stat           /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_findnode
+ ****************************************************************************/
+
+static int heap_findnode(FAR const char *relpath)
+{
+  int node;
+
+  for (node = 0; node < (int)HEAP_NNODES; node++)
+    {
+      if (strcmp(relpath, g_heapnodes[node]) == 0)
+        {
+          return node;
+        }
+    }
+
+  fdbg("ERROR: relpath is '%s'\n", relpath);
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: heap_fragwalker
+ ****************************************************************************/
+
+static void heap_fragwalker(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct heap_frag_s *frag = (FAR struct heap_frag_s *)arg;
+  size_t size = node->size;
+  int ndx = 0;
+
+  if ((node->preceding & MM_ALLOC_BIT) == 0)
+    {
+      for (size >>= MM_MIN_SHIFT + 1; size && ndx < HEAP_NBUCKETS - 1;
+           size >>= 1)
+        {
+          ndx++;
+        }
+
+      frag->nfree[ndx]++;
+      frag->free[ndx] += node->size;
+
+      if (node->size > frag->largest)
+        {
+          frag->largest = node->size;
+        }
+    }
+}
+
+#ifdef CONFIG_MM_TRACE
+/****************************************************************************
+ * Name: heap_sitewalker
+ ****************************************************************************/
+
+static void heap_sitewalker(FAR struct mm_allocnode_s *node, FAR void *arg)
+{
+  FAR struct heap_sitewalk_s *walk = (FAR struct heap_sitewalk_s *)arg;
+  FAR struct heap_site_s *site;
+  FAR struct mm_tracetag_s *tag;
+  uint16_t age;
+  int ndx;
+  int i;
+
+  if ((node->preceding & MM_ALLOC_BIT) == 0)
+    {
+      return;
+    }
+
+  /* Chunks that are not in use have no caller */
+
+  tag = MM_TRACE_TAG(node);
+  if (tag->caller == NULL)
+    {
+      return;
+    }
+
+  /* Find the entry of the call site, or an empty one */
+
+  ndx  = ((uintptr_t)tag->caller >> 1) % HEAP_NSITES;
+  site = &walk->sites[HEAP_NSITES];
+
+  for (i = 0; i < HEAP_NSITES; i++)
+    {
+      if (walk->sites[ndx].caller == tag->caller ||
+          walk->sites[ndx].caller == NULL)
+        {
+          site = &walk->sites[ndx];
+          site->caller = tag->caller;
+          break;
+        }
+
+      ndx = (ndx + 1) % HEAP_NSITES;
+    }
+
+  age = walk->now - tag->stamp;
+
+  site->count++;
+  site->bytes += node->size;
+  if (age > site->age)
+    {
+      site->age = age;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_sitecompare
+ *
+ * Description:
+ *   Sort the call sites by decreasing memory use, the empty entries last.
+ *
+ ****************************************************************************/
+
+static int heap_sitecompare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct heap_site_s *sa = (FAR const struct heap_site_s *)a;
+  FAR const struct heap_site_s *sb = (FAR const struct heap_site_s *)b;
+
+  if (sa->bytes != sb->bytes)
+    {
+      return sa->bytes < sb->bytes ? 1 : -1;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: heap_snapshot
+ *
+ * Description:
+ *   Take the snapshot of an open file.
+ *
+ ****************************************************************************/
+
+static void heap_snapshot(FAR struct heap_file_s *heapfile)
+{
+#ifdef CONFIG_MM_TRACE
+  struct heap_sitewalk_s walk;
+  int i;
+#endif
+
+  switch (heapfile->node)
+    {
+    case HEAP_FRAG:
+      heapfile->u.frag.arena = HEAP_HEAP->mm_heapsize;
+      mm_walk(HEAP_HEAP, heap_fragwalker, &heapfile->u.frag);
+#ifdef CONFIG_MM_CACHE
+      (void)mm_cacheinfo(HEAP_HEAP, &heapfile->u.frag.cache);
+#endif
+      heapfile->nitems = HEAP_NBUCKETS;
+      break;
+
+#ifdef CONFIG_MM_TRACE
+    case HEAP_SITES:
+      walk.sites = heapfile->u.sites;
+      walk.now   = clock_systimer() / CLK_TCK;
+      mm_walk(HEAP_HEAP, heap_sitewalker, &walk);
+
+      qsort(heapfile->u.sites, HEAP_NSITES, sizeof(struct heap_site_s),
+            heap_sitecompare);
+
+      for (i = 0; i < HEAP_NSITES && heapfile->u.sites[i].count > 0; i++);
+
+      /* Keep the entry of the other call sites, if it is used */
+
+      if (heapfile->u.sites[HEAP_NSITES].count > 0)
+        {
+          heapfile->u.sites[i] = heapfile->u.sites[HEAP_NSITES];
+          i++;
+        }
+
+      heapfile->nitems = i;
+      break;
+
+    case HEAP_TRACE:
+      heapfile->nitems = mm_tracedump(heapfile->u.events, HEAP_NEVENTS);
+      break;
+#endif
+
+    default:
+      break;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_header
+ *
+ * Description:
+ *   Format the first line of a file.
+ *
+ ****************************************************************************/
+
+static size_t heap_header(FAR struct heap_file_s *heapfile)
+{
+  switch (heapfile->node)
+    {
+    case HEAP_FRAG:
+      return snprintf(heapfile->line, HEAP_LINELEN, "%-10s %8s %10s\n",
+                      "Size", "Free", "Bytes");
+
+#ifdef CONFIG_MM_TRACE
+    case HEAP_SITES:
+      return snprintf(heapfile->line, HEAP_LINELEN, "%-10s %8s %10s %6s\n",
+                      "Caller", "Count", "Bytes", "Age");
+
+    case HEAP_TRACE:
+      return snprintf(heapfile->line, HEAP_LINELEN,
+                      "%-10s %5s %-10s %-10s %8s\n",
+                      "Time", "PID", "Caller", "Memory", "Size");
+#endif
+
+    default:
+      return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_item
+ *
+ * Description:
+ *   Format the line of one item of the snapshot.
+ *
+ ****************************************************************************/
+
+static size_t heap_item(FAR struct heap_file_s *heapfile, int i)
+{
+#ifdef CONFIG_MM_TRACE
+  FAR struct heap_site_s *site;
+  FAR struct mm_traceevent_s *event;
+#endif
+
+  switch (heapfile->node)
+    {
+    case HEAP_FRAG:
+      return snprintf(heapfile->line, HEAP_LINELEN, "%-10lu %8lu %10lu\n",
+                      (unsigned long)MM_MIN_CHUNK << i,
+                      (unsigned long)heapfile->u.frag.nfree[i],
+                      (unsigned long)heapfile->u.frag.free[i]);
+
+#ifdef CONFIG_MM_TRACE
+    case HEAP_SITES:
+      site = &heapfile->u.sites[i];
+      if (site->caller == NULL)
+        {
+          return snprintf(heapfile->line, HEAP_LINELEN,
+                          "%-10s %8lu %10lu %6u\n", "other",
+                          (unsigned long)site->count,
+                          (unsigned long)site->bytes, site->age);
+        }
+
+      return snprintf(heapfile->line, HEAP_LINELEN,
+                      "0x%08lx %8lu %10lu %6u\n",
+                      (unsigned long)(uintptr_t)site->caller,
+                      (unsigned long)site->count,
+                      (unsigned long)site->bytes, site->age);
+
+    case HEAP_TRACE:
+      event = &heapfile->u.events[i];
+      return snprintf(heapfile->line, HEAP_LINELEN,
+                      "%-10lu %5d 0x%08lx 0x%08lx %8lu\n",
+                      (unsigned long)event->time, event->pid,
+                      (unsigned long)(uintptr_t)event->caller,
+                      (unsigned long)(uintptr_t)event->mem,
+                      (unsigned long)event->size);
+#endif
+
+    default:
+      return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_footer
+ *
+ * Description:
+ *   Format the lines following the items, if any.  Returns 0 when there
+ *   are no more lines.
+ *
+ ****************************************************************************/
+
+static size_t heap_footer(FAR struct heap_file_s *heapfile, int i)
+{
+  FAR struct heap_frag_s *frag = &heapfile->u.frag;
+  unsigned long nfree = 0;
+  unsigned long nbytes = 0;
+  unsigned long fragmented = 0;
+  int ndx;
+
+  if (heapfile->node != HEAP_FRAG)
+    {
+      return 0;
+    }
+
+  switch (i)
+    {
+    case 0:
+      for (ndx = 0; ndx < HEAP_NBUCKETS; ndx++)
+        {
+          nfree  += frag->nfree[ndx];
+          nbytes += frag->free[ndx];
+        }
+
+      /* The fragmentation is the part of the free memory that cannot be
+       * allocated at once.
+       */
+
+      if (nbytes > 0)
+        {
+          fragmented = 100 - (uint64_t)frag->largest * 100 / nbytes;
+        }
+
+      return snprintf(heapfile->line, HEAP_LINELEN,
+                      "%lu of %lu bytes free in %lu chunks, %lu%% fragmented\n",
+                      nbytes, (unsigned long)frag->arena, nfree, fragmented);
+
+#ifdef CONFIG_MM_CACHE
+    case 1:
+      return snprintf(heapfile->line, HEAP_LINELEN,
+                      "%lu bytes cached, %lu hits, %lu refills, %lu drains\n",
+                      (unsigned long)frag->cache.cached, frag->cache.hits,
+                      frag->cache.refills, frag->cache.drains);
+#endif
+
+    default:
+      return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_open
+ ****************************************************************************/
+
+static int heap_open(FAR struct file *filep, FAR const char *relpath,
+                     int oflags, mode_t mode)
+{
+  FAR struct heap_file_s *heapfile;
+  size_t allocsize;
+  int node;
+
+  fvdbg("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      fdbg("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  node = heap_findnode(relpath);
+  if (node < 0)
+    {
+      return node;
+    }
+
+  /* Allocate a container to hold the file attributes and snapshot, only
+   * as large as this type of file needs.
+   */
+
+  allocsize = offsetof(struct heap_file_s, u);
+  switch (node)
+    {
+    case HEAP_FRAG:
+      allocsize += sizeof(struct heap_frag_s);
+      break;
+
+#ifdef CONFIG_MM_TRACE
+    case HEAP_SITES:
+      allocsize += (HEAP_NSITES + 1) * sizeof(struct heap_site_s);
+      break;
+
+    case HEAP_TRACE:
+      allocsize += HEAP_NEVENTS * sizeof(struct mm_traceevent_s);
+      break;
+#endif
+    }
+
+  heapfile = (FAR struct heap_file_s *)kmm_zalloc(allocsize);
+  if (!heapfile)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  heapfile->node      = node;
+  heapfile->allocsize = allocsize;
+
+  /* The snapshot is taken now, so that the file remains consistent
+   * however it is read.
+   */
+
+  heap_snapshot(heapfile);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)heapfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_close
+ ****************************************************************************/
+
+static int heap_close(FAR struct file *filep)
+{
+  FAR struct heap_file_s *heapfile;
+
+  /* Recover our private data from the struct file instance */
+
+  heapfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(heapfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(heapfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_read
+ ****************************************************************************/
+
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct heap_file_s *heapfile;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  heapfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(heapfile);
+
+  /* Format the whole file, line by line, and transfer the part of it at
+   * the file position.
+   */
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  for (i = -1; totalsize < buflen; i++)
+    {
+      if (i < 0)
+        {
+          linesize = heap_header(heapfile);
+        }
+      else if (i < heapfile->nitems)
+        {
+          linesize = heap_item(heapfile, i);
+        }
+      else
+        {
+          linesize = heap_footer(heapfile, i - heapfile->nitems);
+        }
+
+      if (linesize == 0)
+        {
+          break;
+        }
+
+      copysize   = procfs_memcpy(heapfile->line, linesize, buffer,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heap_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heap_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heap_file_s *oldfile;
+  FAR struct heap_file_s *newfile;
+
+  fvdbg("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldfile = (FAR struct heap_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldfile);
+
+  /* Allocate a new container to hold the attributes and snapshot */
+
+  newfile = (FAR struct heap_file_s *)kmm_malloc(oldfile->allocsize);
+  if (!newfile)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newfile, oldfile, oldfile->allocsize);
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heap_stat(const char *relpath, struct stat *buf)
+{
+  int node;
+
+  node = heap_findnode(relpath);
+  if (node < 0)
+    {
+      return node;
+    }
+
+  /* All of the heap files are read-only */
+
+  buf->st_mode    = S_IFREG|S_IROTH|S_IRGRP|S_IRUSR;
+  buf->st_size    = 0;
+  buf->st_blksize = 0;
+  buf->st_blocks  = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_FS_PROCFS_EXCLUDE_HEAP && ... */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
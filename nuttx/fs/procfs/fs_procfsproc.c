@@ -76,7 +76,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define STATUS_LINELEN 32
+#define STATUS_LINELEN 40
 
 /****************************************************************************
  * Private Types
@@ -92,6 +92,9 @@ enum proc_node_e
   PROC_CMDLINE,                       /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   PROC_LOADAVG,                       /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  PROC_SCHEDSTAT,                     /* Scheduler statistics */
 #endif
   PROC_STACK,                         /* Task stack info */
   PROC_GROUP,                         /* Group directory */
@@ -148,6 +151,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -230,6 +238,13 @@ static const struct proc_node_s g_loadavg =
 };
 #endif
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static const struct proc_node_s g_schedstat =
+{
+  "schedstat",    "schedstat", (uint8_t)PROC_SCHEDSTAT,  DTYPE_FILE        /* Scheduler statistics */
+};
+#endif
+
 static const struct proc_node_s g_stack =
 {
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
@@ -258,6 +273,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_cmdline,      /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Scheduler statistics */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -274,6 +292,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_cmdline,      /* Task command line */
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Scheduler statistics */
 #endif
   &g_stack,        /* Task stack info */
   &g_group,        /* Group directory */
@@ -590,6 +611,121 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedtime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static size_t proc_schedtime(FAR struct proc_file_s *procfile,
+                             FAR const char *name, uint64_t usec)
+{
+  /* Times are shown in seconds */
+
+  return snprintf(procfile->line, STATUS_LINELEN, "%-13s%lu.%06lu s\n",
+                  name, (unsigned long)(usec / 1000000),
+                  (unsigned long)(usec % 1000000));
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_schedstatline
+ *
+ * Description:
+ *   Format a line of the scheduler statistics.  Returns 0 past the last
+ *   line.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static size_t proc_schedstatline(FAR struct proc_file_s *procfile,
+                                 FAR const struct schedstat_s *stat,
+                                 int line)
+{
+  FAR const char *name;
+  uint32_t count;
+
+  switch (line)
+    {
+    case 0:
+      return proc_schedtime(procfile, "RunTime:", stat->runtime);
+
+    case 1:
+      return proc_schedtime(procfile, "WaitTime:", stat->waittime);
+
+    case 2:
+      return snprintf(procfile->line, STATUS_LINELEN, "%-13s%lu us\n",
+                      "MaxLatency:", (unsigned long)stat->maxlatency);
+
+    case 3:
+      name  = "Switches:";
+      count = stat->nswitches;
+      break;
+
+    case 4:
+      name  = "Wakeups:";
+      count = stat->nwakeups;
+      break;
+
+    case 5:
+      name  = "Voluntary:";
+      count = stat->nvcsw;
+      break;
+
+    case 6:
+      name  = "Involuntary:";
+      count = stat->nivcsw;
+      break;
+
+    default:
+      return 0;
+    }
+
+  return snprintf(procfile->line, STATUS_LINELEN, "%-13s%lu\n",
+                  name, (unsigned long)count);
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                              FAR struct tcb_s *tcb, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  struct schedstat_s stat;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int line;
+
+  /* Sample the statistics of the thread.  sched_schedstat should only fail
+   * if the PID is not valid, which was checked with the interrupts
+   * disabled.
+   */
+
+  (void)sched_schedstat(procfile->pid, &stat);
+
+  totalsize = 0;
+  for (line = 0; totalsize < buflen; line++)
+    {
+      linesize = proc_schedstatline(procfile, &stat, line);
+      if (linesize == 0)
+        {
+          break;
+        }
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_stack
  ****************************************************************************/
@@ -1063,6 +1199,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
     case PROC_LOADAVG: /* Average CPU utilization */
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
+#endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+    case PROC_SCHEDSTAT: /* Scheduler statistics */
+      ret = proc_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
 #endif
     case PROC_STACK: /* Task stack info */
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -1713,6 +1713,21 @@ char up_romgetc(FAR const char *ptr);
 void up_mdelay(unsigned int milliseconds);
 void up_udelay(useconds_t microseconds);
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Return the one's complement sum of nwords 16-bit words, in host byte
+ *   order.  data is halfword aligned.  The sum may be returned on 32 bits:
+ *   the network layer folds it.  If CONFIG_ARCH_HAVE_CHKSUM is selected,
+ *   the architecture provides this function for the Internet checksums.
+ *
+ ***************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+uint32_t up_chksum(FAR const uint16_t *data, size_t nwords);
+#endif
+
 /****************************************************************************
  * Name: up_cxxinitialize
  *
@@ -31,9 +31,25 @@
 #ifndef __NUTTX_MM_BUFRAM_H__
 #define __NUTTX_MM_BUFRAM_H__
 
+#include <nuttx/config.h>
+
 #include <stddef.h>
+#include <stdint.h>
 
 #define BUFRAM_PAGE_SIZE    128
+#define BUFRAM_ORDER_MAX    31
+
+#ifdef CONFIG_MM_BUFRAM_STATS
+/* Usage of the buffers of one order */
+struct bufram_stats {
+    size_t free;        /* Free buffers */
+    size_t cached;      /* Free buffers not merged yet */
+    size_t used;        /* Allocated buffers */
+    size_t peak;        /* Highest number of allocated buffers */
+    size_t allocs;      /* Number of allocations */
+    size_t fails;       /* Number of failed allocations */
+};
+#endif
 
 void bufram_init(void);
 void bufram_register_region(uintptr_t base, unsigned order);
@@ -46,5 +62,9 @@ void bufram_page_free(void *ptr, size_t page_count);
 
 size_t bufram_size_to_page_count(size_t size);
 
+#ifdef CONFIG_MM_BUFRAM_STATS
+int bufram_get_stats(unsigned order, struct bufram_stats *stats);
+#endif
+
 #endif /* __NUTTX_MM_BUFRAM_H__ */
 
@@ -47,7 +47,15 @@ enum gb_event {
     GB_EVT_DISCONNECTED,
 };
 
+/* Priority of a cport in the run queue of the worker pool */
+enum gb_worker_priority {
+    GB_WORKER_PRIO_NORMAL,
+    GB_WORKER_PRIO_HIGH,
+    GB_WORKER_PRIO_COUNT,
+};
+
 struct gb_operation;
+struct gb_rx_pool;
 
 typedef void (*gb_operation_callback)(struct gb_operation *operation);
 typedef uint8_t (*gb_operation_handler_t)(struct gb_operation *operation);
@@ -90,6 +98,16 @@ struct gb_operation_handler {
 #endif
 };
 
+#define GB_BATCH_MAX_OPS        8
+
+struct gb_transport_msg {
+    unsigned int cport;
+    const void *buf;
+    size_t len;
+};
+
+typedef void (*gb_transport_send_done)(int status, void *priv);
+
 struct gb_transport_backend {
     int headroom;
 
@@ -100,13 +118,32 @@ struct gb_transport_backend {
     int (*send)(unsigned int cport, const void *buf, size_t len);
     void *(*alloc_buf)(size_t size);
     void (*free_buf)(void *ptr);
+
+    /*
+     * Optional: send several messages in one go. Returns the number of
+     * messages queued, in order, or a negative errno if none could be. When
+     * not provided, the core falls back to calling send(), or send_async()
+     * if provided, for each message. Batches are always flushed through
+     * send_batch() when it is provided, even if send_async() is too.
+     */
+    int (*send_batch)(const struct gb_transport_msg *msgs, size_t count);
+
+    /*
+     * Optional: queue a buffer returned by alloc_buf() (offset by headroom)
+     * without copying it. On success, the backend may use the buffer and
+     * its headroom until it calls done(), exactly once. When provided, the
+     * core sends every operation through it, except batches when
+     * send_batch() is provided.
+     */
+    int (*send_async)(unsigned int cport, const void *buf, size_t len,
+                      gb_transport_send_done done, void *priv);
 };
 
 struct gb_operation {
     unsigned int cport;
     bool has_responded;
     atomic_t ref_count;
-    struct timespec time;
+    uint32_t deadline; /* in system ticks */
 
     void *request_headroom;
     void *response_headroom;
@@ -114,12 +151,15 @@ struct gb_operation {
     void *request_buffer;
     void *response_buffer;
     bool is_unipro_rx_buf;
+    struct gb_rx_pool *rx_pool;
 
     gb_operation_callback callback;
     sem_t sync_sem;
 
     void *priv_data;
     struct list_head list;
+    struct list_head inflight;
+    struct list_head timer;
 
     struct gb_operation *response;
 
@@ -140,6 +180,50 @@ struct gb_driver {
     size_t stack_size;
     size_t op_handlers_count;
     const char *name;
+
+    /* only used when CONFIG_GREYBUS_WORKER_POOL is set */
+    bool dedicated_worker;
+    uint8_t priority;
+
+    /*
+     * Number of operations preallocated to receive messages without going
+     * through the heap, and maximum payload size of these messages
+     * (GB_MAX_PAYLOAD_SIZE if 0). Not used with CONFIG_UNIPRO_ZERO_COPY.
+     */
+    unsigned int rx_pool_count;
+    size_t rx_pool_payload_size;
+};
+
+struct gb_rx_pool_stats {
+    unsigned size;
+    unsigned used;
+    unsigned high_watermark;
+    unsigned exhausted; /* messages received while the pool was empty */
+    unsigned oversized; /* messages too big for the pool buffers */
+};
+
+struct gb_dispatch_stats {
+    unsigned latency_p50;
+    unsigned latency_p90;
+    unsigned latency_p99;
+
+    unsigned dedicated_threads;
+    unsigned pool_threads;
+    unsigned pooled_cports;
+    ssize_t stack_saved;
+};
+
+/*
+ * Operations queued with gb_operation_batch_request() and
+ * gb_operation_batch_response() are handed to the transport backend together
+ * by gb_operation_batch_flush(). The batch is flushed automatically when full.
+ */
+struct gb_operation_batch {
+    unsigned int count;
+    struct {
+        struct gb_operation *operation;
+        uint8_t flags;
+    } entries[GB_BATCH_MAX_OPS];
 };
 
 struct gb_operation_hdr {
@@ -214,6 +298,7 @@ static inline const char *gb_handler_name(struct gb_operation_handler *handler)
 int gb_init(struct gb_transport_backend *transport);
 void gb_deinit(void);
 int gb_unipro_init(void);
+int gb_sim_backend_init(void);
 int _gb_register_driver(unsigned int cport, struct gb_driver *driver);
 int gb_unregister_driver(unsigned int cport);
 
@@ -231,14 +316,31 @@ int gb_listen(unsigned int cport);
 int gb_stop_listening(unsigned int cport);
 int gb_notify(unsigned cport, enum gb_event event);
 int gb_notify_all(enum gb_event event);
+int gb_get_dispatch_stats(unsigned int cport, struct gb_dispatch_stats *stats);
+void gb_reset_dispatch_stats(unsigned int cport);
+int gb_get_rx_pool_stats(unsigned int cport, struct gb_rx_pool_stats *stats);
 
 void gb_operation_destroy(struct gb_operation *operation);
 void *gb_operation_alloc_response(struct gb_operation *operation, size_t size);
 int gb_operation_send_response(struct gb_operation *operation, uint8_t result);
 int gb_operation_send_request_sync(struct gb_operation *operation);
+int gb_operation_send_request_sync_timeout(struct gb_operation *operation,
+                                           unsigned int timeout_ms);
 int gb_operation_send_request(struct gb_operation *operation,
                               gb_operation_callback callback,
                               bool need_response);
+int gb_operation_send_request_timeout(struct gb_operation *operation,
+                                      gb_operation_callback callback,
+                                      unsigned int timeout_ms);
+void gb_operation_batch_init(struct gb_operation_batch *batch);
+int gb_operation_batch_request(struct gb_operation_batch *batch,
+                               struct gb_operation *operation,
+                               gb_operation_callback callback,
+                               bool need_response);
+int gb_operation_batch_response(struct gb_operation_batch *batch,
+                                struct gb_operation *operation,
+                                uint8_t result);
+int gb_operation_batch_flush(struct gb_operation_batch *batch);
 struct gb_operation *gb_operation_create(unsigned int cport, uint8_t type,
                                          uint32_t req_size);
 void gb_operation_ref(struct gb_operation *operation);
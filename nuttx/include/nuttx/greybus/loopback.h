@@ -78,6 +78,14 @@ struct gb_loopback_statistics {
     unsigned reqs_per_sec_min;
     unsigned reqs_per_sec_max;
     unsigned reqs_per_sec_avg;
+
+    /* time between the reception and the processing of a message (usec) */
+    unsigned dispatch_p50;
+    unsigned dispatch_p90;
+    unsigned dispatch_p99;
+
+    /* stack saved by serving cports from the worker pool (bytes) */
+    int stack_saved;
 };
 
 typedef int (*gb_loopback_cport_cb)(int, void *);
@@ -32,12 +32,31 @@
 #define __GREYBUS_TAPE_H__
 
 #include <sys/types.h>
+#include <stdint.h>
 
 enum {
     GB_TAPE_RDONLY,
     GB_TAPE_WRONLY,
 };
 
+/*
+ * Tapes recorded with CONFIG_GREYBUS_TAPE_ASYNC start with this magic and
+ * hold both received and sent messages, each preceded by a
+ * gb_tape_timed_record_header and padded to a multiple of 4 bytes. Other
+ * tapes are a plain sequence of received messages.
+ */
+#define GB_TAPE_TIMED_MAGIC     0x32544247 /* "GBT2" */
+
+#define GB_TAPE_RECORD_TX       (1 << 0) /* message sent by this side */
+
+struct gb_tape_timed_record_header {
+    uint16_t size;
+    uint16_t cport;
+    uint32_t timestamp; /* in us, since the start of the capture */
+    uint16_t flags;     /* bits 14 and 15 are reserved */
+    uint16_t reserved;
+};
+
 struct gb_tape_mechanism {
     int (*open)(const char *pathname, int mode);
     void (*close)(int fd);
@@ -48,9 +67,11 @@ struct gb_tape_mechanism {
 
 int gb_tape_register_mechanism(struct gb_tape_mechanism *mechanism);
 int gb_tape_arm_semihosting_register(void);
+int gb_tape_file_register(void);
 
 int gb_tape_communication(const char *pathname);
 int gb_tape_stop(void);
+unsigned int gb_tape_dropped_records(void);
 int gb_tape_replay(const char *pathname);
 
 #endif /* __GREYBUS_TAPE_H__ */
@@ -167,6 +167,23 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+#ifdef CONFIG_MM_TLSF
+/* With CONFIG_MM_TLSF, free chunks are kept in the segregated lists of a
+ * two-level segregated fit (TLSF) allocator.  Chunks are segregated by the
+ * position of the most significant bit of their size (the first level)
+ * and then in MM_TLSF_SLCOUNT ranges of equal width (the second level).
+ * Chunks smaller than MM_TLSF_SMALL all go in the first level 0, with one
+ * list per MM_MIN_CHUNK size.  Chunks of MM_MAX_CHUNK and above all go in
+ * the last level.
+ */
+
+#  define MM_TLSF_SLSHIFT  CONFIG_MM_TLSF_SLSHIFT
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLSHIFT)
+#  define MM_TLSF_FLSHIFT  (MM_TLSF_SLSHIFT + MM_MIN_SHIFT)
+#  define MM_TLSF_SMALL    (1 << MM_TLSF_FLSHIFT)
+#  define MM_TLSF_FLCOUNT  (MM_MAX_SHIFT - MM_TLSF_FLSHIFT + 2)
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -244,6 +261,84 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_TRACE
+/* With CONFIG_MM_TRACE, the last bytes of each allocated chunk hold a tag
+ * telling who allocated it and when.  The tag of the chunks that are not
+ * in use (such as the ones held in the caches) has a NULL caller.
+ */
+
+#  ifndef __GNUC__
+#    error CONFIG_MM_TRACE requires __builtin_return_address()
+#  endif
+
+struct mm_tracetag_s
+{
+  FAR void *caller;                /* Return address of the allocation */
+  int16_t pid;                     /* Task that made the allocation */
+  uint16_t stamp;                  /* Time of the allocation, in seconds */
+};
+
+#  define MM_TRACE_TAGSIZE sizeof(struct mm_tracetag_s)
+#  define MM_TRACE_TAG(n) \
+     ((FAR struct mm_tracetag_s *)((FAR char *)(n) + (n)->size) - 1)
+
+/* The allocations and frees are also logged in a ring of events.  Frees
+ * are the events with a zero size.
+ */
+
+struct mm_traceevent_s
+{
+  uint32_t time;                   /* System time of the event, in ticks */
+  FAR void *caller;                /* Return address of the call */
+  FAR void *mem;                   /* Memory allocated or freed */
+  mmsize_t size;                   /* Size requested, 0 for a free */
+  int16_t pid;                     /* Task that made the call */
+};
+
+/* The allocation functions record their own caller, which the wrappers
+ * (such as malloc()) must replace with theirs.
+ */
+
+#  define MM_TRACE_CALLER(mem) \
+     mm_tracecaller(mem, __builtin_return_address(0))
+#else
+#  define MM_TRACE_TAGSIZE     0
+#  define MM_TRACE_CALLER(mem) (mem)
+#endif
+
+#ifdef CONFIG_MM_CACHE
+/* Small-object caches.  There is one cache per chunk size up to
+ * MM_CACHE_MAXCHUNK (allocated node included) and per priority band.
+ */
+
+#  define MM_CACHE_MAXCHUNK \
+     MM_ALIGN_UP(CONFIG_MM_CACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE + \
+                 MM_TRACE_TAGSIZE)
+#  define MM_CACHE_NCLASSES  (MM_CACHE_MAXCHUNK >> MM_MIN_SHIFT)
+#  define MM_CACHE_CLASS(s)  (((s) >> MM_MIN_SHIFT) - 1)
+
+/* A cache is a list of free chunks of one size, linked through their
+ * payload.  The chunks remain marked as allocated in the heap.
+ */
+
+struct mm_cache_s
+{
+  FAR void *head;                  /* First chunk of the list */
+  uint16_t count;                  /* Number of chunks in the list */
+};
+
+/* Cache statistics, as returned by mm_cacheinfo() */
+
+struct mm_cacheinfo_s
+{
+  unsigned long hits;              /* Allocations served by the caches */
+  unsigned long refills;           /* Batches taken from the heap */
+  unsigned long drains;            /* Batches given back to the heap */
+  size_t cached;                   /* Memory held in the caches */
+  size_t maxcached;                /* Largest memory ever held in the caches */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -271,12 +366,32 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are maintained in segregated, doubly linked lists.  The
+   * bitmaps tell which lists are not empty:  one bit per first level
+   * range, and one bit per list of each first level range.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CACHE
+  /* Small-object caches in front of the node list, one set per priority
+   * band.
+   */
+
+  struct mm_cache_s mm_cache[CONFIG_MM_CACHE_NBANDS][MM_CACHE_NCLASSES];
+  struct mm_cacheinfo_s mm_cacheinfo;
+#endif
 };
 
 /****************************************************************************
@@ -370,6 +485,8 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_mallocchunk(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t size);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
@@ -380,6 +497,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR void *mem);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -488,6 +606,13 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 struct mallinfo; /* Forward reference */
 int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
 
+/* Functions contained in mm_walk.c *****************************************/
+
+typedef CODE void (*mm_walker_t)(FAR struct mm_allocnode_s *node,
+                                 FAR void *arg);
+
+void mm_walk(FAR struct mm_heap_s *heap, mm_walker_t walker, FAR void *arg);
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -503,14 +628,40 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c *******************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
+#ifndef CONFIG_MM_TLSF
 int mm_size2ndx(size_t size);
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_CACHE
+void mm_cache_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_cache_flush(FAR struct mm_heap_s *heap);
+int mm_cacheinfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_cacheinfo_s *info);
+#endif
+
+/* Functions contained in mm_trace.c ****************************************/
+
+#ifdef CONFIG_MM_TRACE
+void mm_tracealloc(FAR void *mem, size_t size, FAR void *caller);
+void mm_tracefree(FAR void *mem, FAR void *caller);
+FAR void *mm_tracecaller(FAR void *mem, FAR void *caller);
+int mm_tracedump(FAR struct mm_traceevent_s *events, int nevents);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
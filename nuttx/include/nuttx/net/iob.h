@@ -90,8 +90,19 @@
 
 /* IOB helpers */
 
-#define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#ifdef CONFIG_IOB_BORROWED
+#  define IOB_ISBORROWED(p) ((p)->io_buf != NULL)
+#  define IOB_BUFFER(p)     (IOB_ISBORROWED(p) ? (p)->io_buf : (p)->io_data)
+#  define IOB_FREESPACE(p)  \
+     (IOB_ISBORROWED(p) ? 0 : \
+      CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#else
+#  define IOB_ISBORROWED(p) false
+#  define IOB_BUFFER(p)     ((p)->io_data)
+#  define IOB_FREESPACE(p)  (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#endif
+
+#define IOB_DATA(p)         (&IOB_BUFFER(p)[(p)->io_offset])
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -104,6 +115,14 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_IOB_BORROWED
+/* This function is called when the external data referenced by a borrowed
+ * I/O buffer is no longer needed by the I/O buffer.
+ */
+
+typedef CODE void (*iob_release_t)(FAR void *arg);
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -117,7 +136,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && !defined(CONFIG_IOB_BORROWED)
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -126,6 +145,17 @@ struct iob_s
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
 
+#ifdef CONFIG_IOB_BORROWED
+  /* A borrowed I/O buffer does not own its data:  The data lies in an
+   * external, read-only buffer (such as a memory mapped file) and io_data
+   * is not used.  io_release is called when the I/O buffer is freed.
+   */
+
+  FAR uint8_t *io_buf;       /* External data buffer, NULL if not borrowed */
+  iob_release_t io_release;  /* Called when the external buffer is returned */
+  FAR void *io_arg;          /* Argument passed to io_release */
+#endif
+
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
 };
 
@@ -184,6 +214,29 @@ void iob_initialize(void);
 
 FAR struct iob_s *iob_alloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_borrow
+ *
+ * Description:
+ *   Make an I/O buffer refer to 'len' bytes of external data at 'buf'
+ *   instead of its own payload.  Any data previously held by the I/O
+ *   buffer is discarded and a previously borrowed buffer is released.
+ *   The I/O buffer must not be part of a chain.
+ *
+ *   The data is not copied and must not be modified until 'release' is
+ *   called (with 'arg') when the I/O buffer is freed or borrows another
+ *   buffer.  'release' may be NULL if nothing needs to be done.
+ *
+ *   The borrowed data is read-only:  It may be copied out, cloned, trimmed
+ *   and sent, but not overwritten or packed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_BORROWED
+int iob_borrow(FAR struct iob_s *iob, FAR const void *buf, unsigned int len,
+               iob_release_t release, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
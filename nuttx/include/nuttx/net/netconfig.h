@@ -148,6 +148,12 @@
 # endif
 #endif
 
+/* The number of buckets of the UDP port hash table, Default: 8 */
+
+#ifndef CONFIG_NET_UDP_NHASH
+# define CONFIG_NET_UDP_NHASH 8
+#endif
+
 /* The UDP maximum packet size. This is should not be to set to more
  * than CONFIG_NET_BUFSIZE - NET_LL_HDRLEN - IPUDP_HDRLEN.
  */
@@ -180,6 +186,14 @@
 # define CONFIG_NET_MAX_LISTENPORTS 20
 #endif
 
+/* The number of buckets of the TCP connection, port and listener hash
+ * tables.  Each bucket requires a pointer.
+ */
+
+#ifndef CONFIG_NET_TCP_NHASH
+# define CONFIG_NET_TCP_NHASH 16
+#endif
+
 /* Define the maximum number of concurrently active UDP and TCP
  * ports.  This number must be greater than the number of open
  * sockets in order to support multi-threaded read/write operations.
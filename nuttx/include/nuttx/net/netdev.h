@@ -66,6 +66,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Descriptor ring accessors (see struct netdev_ring_s) */
+
+#ifdef CONFIG_NET_RINGS
+#  define NETDEV_RING_COUNT(r)   ((uint8_t)((r)->nr_head - (r)->nr_tail))
+#  define NETDEV_RING_EMPTY(r)   ((r)->nr_head == (r)->nr_tail)
+#  define NETDEV_RING_FULL(r)    (NETDEV_RING_COUNT(r) >= (r)->nr_size)
+#  define NETDEV_RING_DESC(r,i)  (&(r)->nr_desc[(uint8_t)(i) & ((r)->nr_size - 1)])
+#  define NETDEV_RING_HEAD(r)    NETDEV_RING_DESC(r, (r)->nr_head)
+#  define NETDEV_RING_TAIL(r)    NETDEV_RING_DESC(r, (r)->nr_tail)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -171,6 +182,21 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_TCP_LARGESEND
+  /* TCP large send.  Drivers that can cut TCP data larger than the MSS into
+   * segments set d_largesend to the most TCP data that they take in one
+   * frame; d_buf must then be large enough to hold it.  When a TCP frame in
+   * d_buf carries more than one MSS of data, d_segmss holds the MSS to cut
+   * it with.  d_segmss is only meaningful for TCP frames.  With
+   * CONFIG_NET_RINGS, it is saved in nd_segmss of each frame queued in the
+   * transmit ring and cleared, and the driver loads it back before it
+   * calls tcp_segment().
+   */
+
+  uint16_t d_largesend;
+  uint16_t d_segmss;
+#endif
+
   /* IGMP group list */
 
 #ifdef CONFIG_NET_IGMP
@@ -200,6 +226,33 @@ struct net_driver_s
 
 typedef int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NET_RINGS
+/* Descriptor rings.  A driver with several frame buffers may describe its
+ * transmit and receive buffers with two rings of descriptors.  Each buffer
+ * holds CONFIG_NET_BUFSIZE + CONFIG_NET_GUARDSIZE bytes.  Descriptors are
+ * filled at nr_head and consumed at nr_tail.  The indices run freely and
+ * are reduced modulo nr_size, which must be a power of two no larger than
+ * 128.
+ */
+
+struct netdev_desc_s
+{
+  FAR uint8_t *nd_buf;        /* Frame buffer */
+  uint16_t nd_len;            /* Length of the frame in nd_buf */
+#ifdef CONFIG_NET_TCP_LARGESEND
+  uint16_t nd_segmss;         /* d_segmss of the frame, 0 if not cut */
+#endif
+};
+
+struct netdev_ring_s
+{
+  FAR struct netdev_desc_s *nr_desc; /* The nr_size descriptors */
+  uint8_t nr_size;            /* Number of descriptors */
+  uint8_t nr_head;            /* Next descriptor to be filled */
+  uint8_t nr_tail;            /* Next descriptor to be consumed */
+};
+#endif
+
 /****************************************************************************
  * Public Variables
  ****************************************************************************/
@@ -327,6 +380,50 @@ int devif_input(FAR struct net_driver_s *dev);
 int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback, int hsec);
 
+/****************************************************************************
+ * Descriptor rings
+ *
+ * With CONFIG_NET_RINGS, a driver with rings of transmit and receive
+ * buffers may use these functions in place of devif_poll(), devif_timer()
+ * and devif_input().
+ *
+ * devif_ring_poll() and devif_ring_timer() queue the outgoing frames in the
+ * free descriptors of the transmit ring, and poll the connections again as
+ * long as they have more to send and there is room in the ring.  The
+ * callback is only called to complete each frame for the link layer, with
+ * arp_out() for example.  They return the number of frames queued, which
+ * the driver then transmits.
+ *
+ * devif_ring_input() processes all of the frames in the receive ring.  The
+ * callback does the link layer part of the input of each frame, as the
+ * driver would have done around devif_input().  A reply left in d_buf is
+ * queued in the transmit ring by swapping buffers with its next free
+ * descriptor, so the driver must refill the receive descriptors with the
+ * buffers found there.
+ *
+ * Example:
+ *   n = devif_ring_input(dev, &rxring, &txring, driver_input);
+ *   n += devif_ring_poll(dev, &txring, driver_txpoll);
+ *   if (n > 0)
+ *     {
+ *       devicedriver_send_queued();
+ *     }
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_RINGS
+int devif_ring_poll(FAR struct net_driver_s *dev,
+                    FAR struct netdev_ring_s *txring,
+                    devif_poll_callback_t callback);
+int devif_ring_timer(FAR struct net_driver_s *dev,
+                     FAR struct netdev_ring_s *txring,
+                     devif_poll_callback_t callback, int hsec);
+int devif_ring_input(FAR struct net_driver_s *dev,
+                     FAR struct netdev_ring_s *rxring,
+                     FAR struct netdev_ring_s *txring,
+                     devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Carrier detection
  *
@@ -341,6 +438,31 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback, in
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: tcp_segment
+ *
+ * Description:
+ *   With CONFIG_NET_TCP_LARGESEND, cut the TCP large send in d_buf into
+ *   segments of d_segmss bytes of data, and call the driver callback with
+ *   each of them in d_buf and d_len, as devif_poll() does.  The headers of
+ *   each segment are copied from those of the large send in front of its
+ *   data, over the end of the previous segment:  the callback must be done
+ *   with a segment when it returns.  Any other frame is passed to the
+ *   callback as it is.
+ *
+ * Returned Value:
+ *   The non-zero value returned by the callback if it stopped the
+ *   segmentation, zero otherwise.
+ *
+ * Assumptions:
+ *   Called from the driver with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_LARGESEND
+int tcp_segment(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -368,6 +490,26 @@ int netdev_carrier_off(FAR struct net_driver_s *dev);
 
 uint16_t net_chksum(FAR uint16_t *data, uint16_t len);
 
+/****************************************************************************
+ * Name: net_chksum_update
+ *
+ * Description:
+ *   Update an Internet checksum for the change of one 16-bit word of the
+ *   data it covers, without summing the data again (RFC1624).  Header
+ *   rewrites such as the ICMP echo reply use this.
+ *
+ * Input Parameters:
+ *   chksum - The checksum, as stored in the header
+ *   oldval - The previous value of the word, as stored in the header
+ *   newval - The new value of the word, as stored in the header
+ *
+ * Returned Value:
+ *   The updated checksum, to be stored in the header.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_update(uint16_t chksum, uint16_t oldval, uint16_t newval);
+
 /****************************************************************************
  * Name: net_incr32
  *
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <signal.h>
 #include <semaphore.h>
@@ -245,6 +246,32 @@ struct child_status_s
 };
 #endif
 
+/* struct schedstat_s ************************************************************/
+/* The scheduler statistics kept for each thread with CONFIG_SCHED_SCHEDSTAT,
+ * and for each interrupt.  Times are in microseconds.
+ */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+struct schedstat_s
+{
+  uint64_t runtime;           /* Time spent running, interrupts excluded */
+  uint64_t waittime;          /* Time spent ready to run, waiting for the CPU */
+  uint32_t maxlatency;        /* Longest wait from ready to run to running */
+  uint32_t nswitches;         /* Number of times switched in */
+  uint32_t nwakeups;          /* Number of times unblocked */
+  uint32_t nvcsw;             /* Number of switches out to block */
+  uint32_t nivcsw;            /* Number of switches out while ready to run */
+  uint32_t stamp;             /* Time switched out or unblocked */
+  bool     woken;             /* Unblocked since switched out */
+};
+
+struct irqstat_s
+{
+  uint64_t time;              /* Time spent in the handler, nested ones included */
+  uint32_t count;             /* Number of interrupts */
+};
+#endif
+
 /* struct dspace_s ***************************************************************/
 /* This structure describes a reference counted D-Space region.  This must be a
  * separately allocated "break-away" structure that can be owned by a task and
@@ -489,6 +516,10 @@ struct tcb_s
 #endif
   FAR struct wdog_s *waitdog;            /* All timed waits used this wdog      */
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  struct schedstat_s stat;               /* Scheduler statistics                */
+#endif
+
   /* Stack-Related Fields *******************************************************/
 
   size_t    adj_stack_size;              /* Stack size after adjustment         */
@@ -641,6 +672,13 @@ void sched_foreach(sched_foreach_t handler, FAR void *arg);
 
 FAR struct tcb_s *sched_gettcb(pid_t pid);
 
+/* Sample the scheduler statistics of a thread, or of an interrupt */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+int sched_schedstat(pid_t pid, FAR struct schedstat_s *stat);
+int sched_irqstat(int irq, FAR struct irqstat_s *stat);
+#endif
+
 /* File system helpers **********************************************************/
 /* These functions all extract lists from the group structure assocated with the
  * currently executing task.
@@ -139,6 +139,11 @@ struct wdog_s
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
   uint32_t           parm[CONFIG_MAX_WDOGPARMS];
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+  FAR struct wdog_s *prev;       /* Support for doubly linked wheel slots */
+  uint32_t           expiry;     /* Expiration time, in wheel ticks */
+  uint8_t            slot;       /* Wheel slot holding the watchdog */
+#endif
 };
 
 /* Watchdog 'handle' */
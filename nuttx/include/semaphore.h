@@ -92,11 +92,7 @@ struct sem_s
    */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-# if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
-# else
-  struct semholder_s holder;     /* Single holder */
-# endif
+  struct semholder_s holder;     /* Built-in holder, heads the list of holders */
 #endif
 };
 
@@ -105,11 +101,7 @@ typedef struct sem_s sem_t;
 /* Initializers */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
-# if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEM_INITIALIZER(c) {(c), NULL}  /* semcount, hhead */
-# else
 #  define SEM_INITIALIZER(c) {(c), SEMHOLDER_INITIALIZER} /* semcount, holder */
-# endif
 #else
 #  define SEM_INITIALIZER(c) {(c)} /* semcount */
 #endif
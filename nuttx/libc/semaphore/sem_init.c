@@ -109,11 +109,10 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-      sem->hhead         = NULL;
-#  else
+      sem->holder.flink  = NULL;
+#  endif
       sem->holder.htcb   = NULL;
       sem->holder.counts = 0;
-#  endif
 #endif
       return OK;
     }
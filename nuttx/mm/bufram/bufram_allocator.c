@@ -29,9 +29,11 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <stddef.h>
+#include <string.h>
 
 #include <nuttx/config.h>
 #include <nuttx/list.h>
@@ -41,25 +43,76 @@
 
 #include <arch/chip/chip.h>
 
-#define MM_BUCKET_MAX           31
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+#include <arch/atomic.h>
+#endif
+
+#define MM_BUCKET_MAX           BUFRAM_ORDER_MAX
+#define MM_BUCKET_MIN           5
 #define MM_CANARY               0xfab0fab0
 
+/* States of a buffer */
+#define MM_STATE_USED           0xa11c
+#define MM_STATE_FREE           0xf4ee
+#define MM_STATE_CACHED         0xcac4
+
 #ifdef CONFIG_MM_BUFRAM_DEBUG
 #define mm_warn(message...) lowsyslog(message)
 #else
 #define mm_warn(message...)
 #endif
 
+/*
+ * The counters are updated without masking the interrupts when the free
+ * lists are lock-free.
+ */
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+#define mm_inc(counter) atomic_inc(&(counter))
+#define mm_dec(counter) atomic_dec(&(counter))
+#else
+#define mm_inc(counter) (++(counter))
+#define mm_dec(counter) (--(counter))
+#endif
+
 static struct list_head mm_bucket[MM_BUCKET_MAX + 1];
 
+/*
+ * One bit per buffer of the smallest order, set for the first one of each
+ * buffer in the buckets:  the buddy of a buffer being freed is merged with it
+ * if its bit is set and it has the same order.
+ */
+#define MM_MAP_BITS             (BUFRAM_SIZE >> MM_BUCKET_MIN)
+
+static uint32_t mm_freemap[(MM_MAP_BITS + 31) / 32];
+
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+/*
+ * Freed buffers are pushed on the stack of their order without being merged,
+ * and allocations pop from it first, both without masking the interrupts.
+ * The stacks are only merged back into the buckets, with the interrupts
+ * masked, when an allocation finds its stack empty.
+ */
+static void *volatile mm_stack[MM_BUCKET_MAX + 1];
+#endif
+
+#ifdef CONFIG_MM_BUFRAM_STATS
+static struct {
+    volatile int used;
+    volatile int peak;
+    volatile int allocs;
+    volatile int fails;
+} mm_stats[MM_BUCKET_MAX + 1];
+#endif
+
 #ifdef CONFIG_MM_BUFRAM_DEBUG
-static size_t g_bufram_allocs;
-static size_t g_bufram_frees;
+static volatile int g_bufram_allocs;
+static volatile int g_bufram_frees;
 #endif
 
 struct mm_buffer {
     uint32_t canary;
-    uint32_t bucket;
+    uint16_t bucket;
+    uint16_t state;
     struct list_head list;
 } __attribute__((packed)); // MUST be a multiple of 8 bytes
 
@@ -89,18 +142,51 @@ static size_t order_to_size(int order)
     return 1 << order;
 }
 
+static inline unsigned buffer_index(struct mm_buffer *buffer)
+{
+    return ((uintptr_t) buffer - BUFRAM_BASE) >> MM_BUCKET_MIN;
+}
+
+static inline bool buffer_is_free(struct mm_buffer *buffer)
+{
+    unsigned index = buffer_index(buffer);
+
+    return mm_freemap[index / 32] & ((uint32_t) 1 << (index % 32));
+}
+
+static void add_free_buffer(struct mm_buffer *buffer)
+{
+    unsigned index = buffer_index(buffer);
+
+    buffer->state = MM_STATE_FREE;
+    mm_freemap[index / 32] |= (uint32_t) 1 << (index % 32);
+    list_add(&mm_bucket[buffer->bucket], &buffer->list);
+}
+
+static void del_free_buffer(struct mm_buffer *buffer)
+{
+    unsigned index = buffer_index(buffer);
+
+    mm_freemap[index / 32] &= ~((uint32_t) 1 << (index % 32));
+    list_del(&buffer->list);
+    buffer->state = MM_STATE_USED;
+}
+
 void bufram_register_region(uintptr_t base, unsigned order)
 {
     struct mm_buffer *buffer;
 
+    DEBUGASSERT(order >= MM_BUCKET_MIN && order <= MM_BUCKET_MAX);
+    DEBUGASSERT(base >= BUFRAM_BASE &&
+                base + order_to_size(order) <= BUFRAM_BASE + BUFRAM_SIZE);
+
     buffer = (struct mm_buffer*) base;
     buffer->bucket = order;
 #if defined(CONFIG_MM_BUFRAM_CANARY)
     buffer->canary = MM_CANARY;
 #endif
-    list_init(&buffer->list);
 
-    list_add(&mm_bucket[buffer->bucket], &buffer->list);
+    add_free_buffer(buffer);
 }
 
 void bufram_init(void)
@@ -109,6 +195,8 @@ void bufram_init(void)
 
     for (i = 0; i < ARRAY_SIZE(mm_bucket); i++)
         list_init(&mm_bucket[i]);
+
+    memset(mm_freemap, 0, sizeof(mm_freemap));
 }
 
 static inline void *get_buffer_payload(struct mm_buffer *buffer)
@@ -151,10 +239,9 @@ static int fill_bucket(int order)
         DEBUGASSERT(buffer1);
     }
 
-    list_del(&buffer1->list);
+    del_free_buffer(buffer1);
 
     buffer2 = (struct mm_buffer*) ((char*) buffer1 + order_to_size(order));
-    list_init(&buffer2->list);
 
     buffer1->bucket = order;
     buffer2->bucket = order;
@@ -163,51 +250,69 @@ static int fill_bucket(int order)
     buffer2->canary = buffer1->canary = MM_CANARY;
 #endif
 
-    list_add(&mm_bucket[order], &buffer1->list);
-    list_add(&mm_bucket[order], &buffer2->list);
+    add_free_buffer(buffer1);
+    add_free_buffer(buffer2);
 
     return 0;
 }
 
-static void defragment(struct mm_buffer *buffer)
+/*
+ * Put a buffer back in the buckets, merging it with its buddy for as long as
+ * the buddy is free too.  Only the buffers aligned on their size are merged,
+ * so that their buddy is next to them.
+ */
+static void merge_buffer(struct mm_buffer *buffer)
 {
-    struct list_head *iter;
-    struct mm_buffer *buffer_low;
-    struct mm_buffer *buffer_high;
-    struct mm_buffer *buffer2;
-    struct mm_buffer *buffer3;
+    struct mm_buffer *buddy;
+    uintptr_t offset;
+    size_t size;
 
-    if (list_is_empty(&mm_bucket[buffer->bucket])) {
-        mm_warn("mm: trying to defragment empty bucket");
-        return;
-    }
+    while (buffer->bucket < MM_BUCKET_MAX) {
+        size = order_to_size(buffer->bucket);
+        offset = (uintptr_t) buffer - BUFRAM_BASE;
+        if (offset & (size - 1))
+            break;
 
-    if (((unsigned long) buffer) & (1 << buffer->bucket)) {
-        buffer_low = buffer2 = (struct mm_buffer*)
-            ((char*) buffer - order_to_size(buffer->bucket));
-        buffer_high = buffer;
-    } else {
-        buffer_low = buffer;
-        buffer_high = buffer2 = (struct mm_buffer*)
-            ((char*) buffer + order_to_size(buffer->bucket));
-    }
+        offset ^= size;
+        if (offset + size > BUFRAM_SIZE)
+            break;
 
-    list_foreach(&mm_bucket[buffer->bucket], iter) {
-        buffer3 = list_entry(iter, struct mm_buffer, list);
-        if (buffer3 != buffer2)
-            continue;
+        buddy = (struct mm_buffer*) (BUFRAM_BASE + offset);
+        if (!buffer_is_free(buddy) || buddy->bucket != buffer->bucket)
+            break;
 
-        list_del(&buffer_low->list);
-        list_del(&buffer_high->list);
+        del_free_buffer(buddy);
 
-        buffer_low->bucket++;
-        list_add(&mm_bucket[buffer_low->bucket], &buffer_low->list);
+        if (buddy < buffer)
+            buffer = buddy;
+        buffer->bucket++;
+    }
 
-        defragment(buffer_low);
+    add_free_buffer(buffer);
+}
 
-        return;
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+/*
+ * Merge all of the cached buffers back into the buckets.  The interrupts
+ * must be masked.
+ */
+static void merge_cached_buffers(void)
+{
+    struct list_head *node;
+    struct list_head *next;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(mm_stack); i++) {
+        node = mm_stack[i];
+        mm_stack[i] = NULL;
+
+        for (; node; node = next) {
+            next = node->prev; // link of the stack
+            merge_buffer(list_entry(node, struct mm_buffer, list));
+        }
     }
 }
+#endif
 
 static struct mm_buffer *get_buffer(int order)
 {
@@ -228,11 +333,53 @@ static struct mm_buffer *get_buffer(int order)
     return NULL;
 }
 
+static void *alloc_done(struct mm_buffer *buffer, int order)
+{
+#ifdef CONFIG_MM_BUFRAM_STATS
+    int used;
+#endif
+
+    if (!buffer) {
+#ifdef CONFIG_MM_BUFRAM_STATS
+        mm_inc(mm_stats[order].fails);
+#endif
+        return NULL;
+    }
+
+#ifdef CONFIG_MM_BUFRAM_STATS
+    mm_inc(mm_stats[order].allocs);
+    used = mm_inc(mm_stats[order].used);
+    if (used > mm_stats[order].peak)
+        mm_stats[order].peak = used;
+#endif
+
+#ifdef CONFIG_MM_BUFRAM_DEBUG
+    mm_inc(g_bufram_allocs);
+#endif
+
+    return get_buffer_payload(buffer);
+}
+
+static void free_done(struct mm_buffer *buffer)
+{
+#ifdef CONFIG_MM_BUFRAM_DEBUG
+    mm_inc(g_bufram_frees);
+#endif
+
+#ifdef CONFIG_MM_BUFRAM_STATS
+    mm_dec(mm_stats[buffer->bucket].used);
+#endif
+}
+
 void *bufram_alloc(size_t size)
 {
     int order;
     struct mm_buffer *buffer;
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+    struct list_head *node;
+#endif
     irqstate_t flags;
+    void *ptr;
 
     if (!size)
         return NULL;
@@ -245,36 +392,44 @@ void *bufram_alloc(size_t size)
     if (order > MM_BUCKET_MAX)
         return NULL;
 
-    flags = irqsave();
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+    node = atomic_pop(&mm_stack[order]);
+    if (node) {
+        buffer = list_entry(node, struct mm_buffer, list);
+        buffer->state = MM_STATE_USED;
+        return alloc_done(buffer, order);
+    }
+#endif
 
-    buffer = get_buffer(order);
-    if (!buffer)
-        goto error;
+    flags = irqsave();
 
-#ifdef CONFIG_MM_BUFRAM_DEBUG
-    g_bufram_allocs++;
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+    merge_cached_buffers();
 #endif
 
-    list_del(&buffer->list);
-    irqrestore(flags);
+    buffer = get_buffer(order);
+    if (buffer)
+        del_free_buffer(buffer);
 
-    return get_buffer_payload(buffer);
+    ptr = alloc_done(buffer, order);
 
-error:
     irqrestore(flags);
-    return NULL;
+
+    return ptr;
 }
 
 void bufram_free(void *ptr)
 {
     struct mm_buffer *buffer;
+#ifndef CONFIG_MM_BUFRAM_LOCKFREE
     irqstate_t flags;
+#endif
 
     if (!ptr)
         return;
 
     buffer = get_buffer_control_data(ptr);
-    if (buffer->list.prev != buffer->list.next) {
+    if (buffer->state != MM_STATE_USED) {
         mm_warn("mm: trying to free invalid pointer: %p\n", ptr);
         return;
     }
@@ -286,16 +441,16 @@ void bufram_free(void *ptr)
     }
 #endif
 
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+    free_done(buffer);
+    buffer->state = MM_STATE_CACHED;
+    atomic_push(&mm_stack[buffer->bucket], &buffer->list);
+#else
     flags = irqsave();
-
-#ifdef CONFIG_MM_BUFRAM_DEBUG
-    g_bufram_frees++;
-#endif
-
-    list_add(&mm_bucket[buffer->bucket], &buffer->list);
-    defragment(buffer);
-
+    free_done(buffer);
+    merge_buffer(buffer);
     irqrestore(flags);
+#endif
 }
 
 void *bufram_page_alloc(size_t page_count)
@@ -316,13 +471,14 @@ void bufram_page_free(void *ptr, size_t page_count)
     uintptr_t ptraddr = (uintptr_t) ptr;
     size_t size = page_count * BUFRAM_PAGE_SIZE;
 
-    if (ptraddr < BUFRAM_BASE || ptraddr + size >= BUFRAM_BASE + BUFRAM_SIZE) {
+    if (ptraddr < BUFRAM_BASE || ptraddr + size > BUFRAM_BASE + BUFRAM_SIZE) {
         mm_warn("mm: trying to free invalid pointer: %p\n", ptr);
         return;
     }
 
     list_init(&buffer->list);
     buffer->bucket = size_to_order(size);
+    buffer->state = MM_STATE_USED;
 #if defined(CONFIG_MM_BUFRAM_CANARY)
     buffer->canary = MM_CANARY;
 #endif
@@ -330,6 +486,38 @@ void bufram_page_free(void *ptr, size_t page_count)
     bufram_free(get_buffer_payload(buffer));
 }
 
+#ifdef CONFIG_MM_BUFRAM_STATS
+int bufram_get_stats(unsigned order, struct bufram_stats *stats)
+{
+    struct list_head *iter;
+    irqstate_t flags;
+
+    if (order > MM_BUCKET_MAX)
+        return -EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+
+    flags = irqsave();
+
+    list_foreach(&mm_bucket[order], iter)
+        stats->free++;
+
+#ifdef CONFIG_MM_BUFRAM_LOCKFREE
+    for (iter = mm_stack[order]; iter; iter = iter->prev)
+        stats->cached++;
+#endif
+
+    stats->used = mm_stats[order].used;
+    stats->peak = mm_stats[order].peak;
+    stats->allocs = mm_stats[order].allocs;
+    stats->fails = mm_stats[order].fails;
+
+    irqrestore(flags);
+
+    return 0;
+}
+#endif
+
 #ifdef CONFIG_MM_BUFRAM_DEBUG
 void bufram_dump(void)
 {
@@ -356,7 +544,7 @@ void bufram_dump(void)
                 }
 #endif
 
-                if (buffer->bucket != i) {
+                if (buffer->bucket != i || !buffer_is_free(buffer)) {
                     errors++;
                 }
 
@@ -369,4 +557,4 @@ void bufram_dump(void)
 
     irqrestore(flags);
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,354 @@
+/****************************************************************************
+ * mm/bufram/bufram_procfs.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/bufram.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_BUFRAM) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BUFRAM_LINELEN  64
+#define BUFRAM_NORDERS  (BUFRAM_ORDER_MAX + 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file".  The statistics are taken when
+ * the file is opened, so that it remains consistent however it is read.
+ */
+
+struct bufram_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[BUFRAM_LINELEN];    /* Pre-allocated buffer for formatted lines */
+  struct bufram_stats stats[BUFRAM_NORDERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int     bufram_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     bufram_close(FAR struct file *filep);
+static ssize_t bufram_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     bufram_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     bufram_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bufram_procfsoperations =
+{
+  bufram_open,    /* open */
+  bufram_close,   /* close */
+  bufram_read,    /* read */
+  NULL,           /* write */
+
+  bufram_dup,     /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  bufram_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bufram_line
+ *
+ * Description:
+ *   Format a line of the file:  a header, then one line per order that
+ *   was ever used.  Returns 0 past the last line.
+ *
+ ****************************************************************************/
+
+static size_t bufram_line(FAR struct bufram_file_s *attr, FAR int *order)
+{
+  FAR struct bufram_stats *stats;
+
+  if (*order < 0)
+    {
+      return snprintf(attr->line, BUFRAM_LINELEN,
+                      "%-8s %6s %6s %6s %6s %10s %6s\n", "Size", "Free",
+                      "Cached", "Used", "Peak", "Allocs", "Fails");
+    }
+
+  for (; *order < BUFRAM_NORDERS; (*order)++)
+    {
+      stats = &attr->stats[*order];
+      if (stats->free > 0 || stats->cached > 0 || stats->allocs > 0 ||
+          stats->fails > 0)
+        {
+          return snprintf(attr->line, BUFRAM_LINELEN,
+                          "%-8lu %6lu %6lu %6lu %6lu %10lu %6lu\n",
+                          1ul << *order, (unsigned long)stats->free,
+                          (unsigned long)stats->cached,
+                          (unsigned long)stats->used,
+                          (unsigned long)stats->peak,
+                          (unsigned long)stats->allocs,
+                          (unsigned long)stats->fails);
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bufram_open
+ ****************************************************************************/
+
+static int bufram_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct bufram_file_s *attr;
+  int order;
+
+  fvdbg("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      fdbg("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "bufram" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "bufram") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct bufram_file_s *)kmm_zalloc(sizeof(struct bufram_file_s));
+  if (!attr)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  for (order = 0; order < BUFRAM_NORDERS; order++)
+    {
+      (void)bufram_get_stats(order, &attr->stats[order]);
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bufram_close
+ ****************************************************************************/
+
+static int bufram_close(FAR struct file *filep)
+{
+  FAR struct bufram_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bufram_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bufram_read
+ ****************************************************************************/
+
+static ssize_t bufram_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct bufram_file_s *attr;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int order;
+
+  fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct bufram_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Format the whole file, line by line, and transfer the part of it at
+   * the file position.
+   */
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  for (order = -1; totalsize < buflen; order++)
+    {
+      linesize = bufram_line(attr, &order);
+      if (linesize == 0)
+        {
+          break;
+        }
+
+      copysize   = procfs_memcpy(attr->line, linesize, buffer,
+                                 buflen - totalsize, &offset);
+      totalsize += copysize;
+      buffer    += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: bufram_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bufram_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bufram_file_s *oldattr;
+  FAR struct bufram_file_s *newattr;
+
+  fvdbg("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bufram_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the attributes and statistics */
+
+  newattr = (FAR struct bufram_file_s *)
+    kmm_malloc(sizeof(struct bufram_file_s));
+  if (!newattr)
+    {
+      fdbg("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bufram_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bufram_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bufram_stat(const char *relpath, struct stat *buf)
+{
+  if (strcmp(relpath, "bufram") != 0)
+    {
+      fdbg("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "bufram" is the name for a read-only file */
+
+  buf->st_mode    = S_IFREG|S_IROTH|S_IRGRP|S_IRUSR;
+  buf->st_size    = 0;
+  buf->st_blksize = 0;
+  buf->st_blocks  = 0;
+  return OK;
+}
+
+#endif /* !CONFIG_FS_PROCFS_EXCLUDE_BUFRAM && CONFIG_FS_PROCFS */
@@ -74,7 +74,7 @@
 
 FAR void *kmm_memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(&g_kmmheap, alignment, size);
+  return MM_TRACE_CALLER(mm_memalign(&g_kmmheap, alignment, size));
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
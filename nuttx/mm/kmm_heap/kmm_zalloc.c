@@ -67,7 +67,7 @@
 
 FAR void *kmm_zalloc(size_t size)
 {
-  return mm_zalloc(&g_kmmheap, size);
+  return MM_TRACE_CALLER(mm_zalloc(&g_kmmheap, size));
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
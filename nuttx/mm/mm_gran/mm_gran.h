@@ -59,6 +59,21 @@
 #define SIZEOF_GRAN_S(n) \
   (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
 
+/* Allocations are sorted in GRAN_NCLASSES size classes of 1, 2-3, 4-7, ...
+ * granules, the last class holding all of the larger ones.  Each class has
+ * a hint of where its search may start (see struct gran_s).
+ */
+
+#define GRAN_NCLASSES    8
+#define GRAN_CLASSMIN(n) (1u << (n))
+
+/* Count leading and trailing zeros of a non-zero GAT entry */
+
+#ifdef __GNUC__
+#  define gran_clz(value) __builtin_clz(value)
+#  define gran_ctz(value) __builtin_ctz(value)
+#endif
+
 /* Debug */
 
 #ifdef CONFIG_CPP_HAVE_VARARGS
@@ -95,9 +110,57 @@ struct gran_s
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+
+  /* There is no run of GRAN_CLASSMIN(n) free granules or more starting
+   * before the granule hint[n].  Allocations update the hint of their own
+   * class, frees move the hints of all classes back.
+   */
+
+  uint16_t   hint[GRAN_NCLASSES];
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifndef __GNUC__
+static inline unsigned int gran_clz(uint32_t value)
+{
+  unsigned int bit = 0;
+
+  while ((value & 0x80000000) == 0)
+    {
+      value <<= 1;
+      bit++;
+    }
+
+  return bit;
+}
+
+static inline unsigned int gran_ctz(uint32_t value)
+{
+  unsigned int bit = 0;
+
+  while ((value & 1) == 0)
+    {
+      value >>= 1;
+      bit++;
+    }
+
+  return bit;
+}
+#endif
+
+/* Return the size class of an allocation of ngranules (non-zero) granules */
+
+static inline unsigned int gran_class(unsigned int ngranules)
+{
+  unsigned int sclass = 31 - gran_clz(ngranules);
+
+  return sclass < GRAN_NCLASSES ? sclass : GRAN_NCLASSES - 1;
+}
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -148,4 +211,24 @@ void gran_leave_critical(FAR struct gran_s *priv);
 void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
                          unsigned int ngranules);
 
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free and move the search hints back to the
+ *   start of the free run now containing them.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The first granule of the range.
+ *   ngranules - The number of granules freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules);
+
 #endif /* __MM_MM_GRAN_MM_GRAN_H */
@@ -55,12 +55,89 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: gran_next_free
+ *
+ * Description:
+ *   Return the first free granule at or after granno, skipping whole runs
+ *   of allocated granules at a time, or the number of granules in the heap
+ *   if there is none.
+ *
+ ****************************************************************************/
+
+static inline unsigned int gran_next_free(FAR struct gran_s *priv,
+                                          unsigned int granno)
+{
+  unsigned int gatidx = granno >> 5;
+  uint32_t     curr;
+
+  if (granno >= priv->ngranules)
+    {
+      return priv->ngranules;
+    }
+
+  /* Consider the granules below granno in its entry as allocated */
+
+  curr = priv->gat[gatidx] | ((1u << (granno & 31)) - 1);
+  while (curr == 0xffffffff)
+    {
+      if (++gatidx >= SIZEOF_GAT(priv->ngranules))
+        {
+          return priv->ngranules;
+        }
+
+      curr = priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + gran_ctz(~curr);
+  return granno < priv->ngranules ? granno : priv->ngranules;
+}
+
+/****************************************************************************
+ * Name: gran_next_alloc
+ *
+ * Description:
+ *   Return the first allocated granule at or after granno, skipping whole
+ *   runs of free granules at a time, or limit if there is none before it.
+ *
+ ****************************************************************************/
+
+static inline unsigned int gran_next_alloc(FAR struct gran_s *priv,
+                                           unsigned int granno,
+                                           unsigned int limit)
+{
+  unsigned int gatidx = granno >> 5;
+  uint32_t     curr;
+
+  /* Consider the granules below granno in its entry as free */
+
+  curr = priv->gat[gatidx] & (0xffffffff << (granno & 31));
+  while (curr == 0)
+    {
+      if ((++gatidx << 5) >= limit)
+        {
+          return limit;
+        }
+
+      curr = priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + gran_ctz(curr);
+  return granno < limit ? granno : limit;
+}
+
 /****************************************************************************
  * Name: gran_common_alloc
  *
  * Description:
  *   Allocate memory from the granule heap.
  *
+ *   The search is first fit, from the hint of the size class of the
+ *   allocation.  It goes from one free run to the next, counting trailing
+ *   zeros in the GAT entries to skip the allocated and free runs, until one
+ *   is long enough.  It also notes the first run long enough for the
+ *   smallest allocation of the class, which becomes the next hint.
+ *
  * Input Parameters:
  *   priv - The granule heap state structure.
  *   size - The size of the memory region to allocate.
@@ -73,182 +150,88 @@
 static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
 {
   unsigned int ngranules;
+  unsigned int sclass;
+  unsigned int granno;
+  unsigned int firstfit;
+  unsigned int end;
   size_t       tmpmask;
-  uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
+  FAR void    *alloc = NULL;
 
-  DEBUGASSERT(priv && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv);
 
   if (priv && size > 0)
     {
-      /* Get exclusive access to the GAT */
-
-      gran_enter_critical(priv);
-
       /* How many contiguous granules we we need to find? */
 
       tmpmask   = (1 << priv->log2gran) - 1;
-      ngranules = (size + tmpmask) >> priv->log2gran;
-
-      /* Then create mask for that number of granules */
-
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
-
-      /* Now search the granule allocation table for that number of contiguous */
-
-      alloc = priv->heapstart;
-
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      if (size > ((size_t)priv->ngranules << priv->log2gran))
         {
-          /* Get the GAT index associated with the granule table entry */
+          return NULL;
+        }
 
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
+      ngranules = (size + tmpmask) >> priv->log2gran;
+      sclass    = gran_class(ngranules);
+      firstfit  = priv->ngranules;
 
-          /* Handle the case where there are no free granules in the entry */
+      /* Get exclusive access to the GAT */
 
-          if (curr == 0xffffffff)
-            {
-              alloc += (32 << priv->log2gran);
-              continue;
-            }
+      gran_enter_critical(priv);
 
-          /* Get the next entry from the GAT to support a 64 bit shift */
+      /* Now search the granule allocation table for that number of
+       * contiguous granules.
+       */
 
-          if (granidx < priv->ngranules)
+      granno = priv->hint[sclass];
+      for (; ; )
+        {
+          granno = gran_next_free(priv, granno);
+          if (granno + ngranules > priv->ngranules)
             {
-              next = priv->gat[gatidx + 1];
-            }
+              /* Nothing left that could fit */
 
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
+              if (firstfit > granno)
+                {
+                  firstfit = granno;
+                }
 
-          else
-            {
-              next = 0xffffffff;
+              break;
             }
 
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
+          /* Only look as far as the end of the allocation for the end of
+           * the free run.
            */
 
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
+          end = gran_next_alloc(priv, granno, granno + ngranules);
+          if (end - granno >= ngranules)
             {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
+              /* Found.. mark these granules allocated */
 
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
+              alloc = (FAR void *)(priv->heapstart +
+                                   ((uintptr_t)granno << priv->log2gran));
+              gran_mark_allocated(priv, (uintptr_t)alloc, ngranules);
 
-              else if ((curr & 0x0000ff) == 0x000000ff)
+              if (firstfit > granno + ngranules)
                 {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
+                  firstfit = granno + ngranules;
                 }
 
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position andi ncrement
-               * to the next candidate allocation address.
-               */
+              break;
+            }
 
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
+          if (firstfit == priv->ngranules &&
+              end - granno >= GRAN_CLASSMIN(sclass))
+            {
+              firstfit = granno;
             }
+
+          granno = end;
         }
+
+      priv->hint[sclass] = firstfit;
+      gran_leave_critical(priv);
     }
 
-  gran_leave_critical(priv);
-  return NULL;
+  return alloc;
 }
 
 /****************************************************************************
@@ -261,10 +244,6 @@ static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
  *   size   - The size of the memory region to allocate.
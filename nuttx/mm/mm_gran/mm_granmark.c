@@ -93,39 +93,105 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
   gatidx = granno >> 5;
   gatbit = granno & 31;
 
-  /* Mark bits in the GAT entry or entries */
+  /* Mark bits in the GAT entry or entries.  Only the first and the last
+   * entries can be partially marked.
+   */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
+      avail   = 32 - gatbit;
+      gatmask = 0xffffffff << gatbit;
 
-      gatmask =0xffffffff << gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+      if (ngranules < avail)
+        {
+          gatmask &= 0xffffffff >> (avail - ngranules);
+          avail    = ngranules;
+        }
 
+      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
       priv->gat[gatidx] |= gatmask;
+
       ngranules -= avail;
+      gatidx++;
+      gatbit     = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: gran_mark_free
+ *
+ * Description:
+ *   Mark a range of granules as free and move the search hints back to the
+ *   start of the free run now containing them.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The first granule of the range.
+ *   ngranules - The number of granules freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-      /* Mark bits in the second GAT entry */
+void gran_mark_free(FAR struct gran_s *priv, unsigned int granno,
+                    unsigned int ngranules)
+{
+  unsigned int gatidx = granno >> 5;
+  unsigned int gatbit = granno & 31;
+  unsigned int avail;
+  unsigned int runstart;
+  uint32_t     gatmask;
+  uint32_t     curr;
+  int          i;
+
+  /* Clear bits in the GAT entry or entries */
 
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
+  while (ngranules > 0)
+    {
+      avail   = 32 - gatbit;
+      gatmask = 0xffffffff << gatbit;
+
+      if (ngranules < avail)
+        {
+          gatmask &= 0xffffffff >> (avail - ngranules);
+          avail    = ngranules;
+        }
 
-      priv->gat[gatidx+1] |= gatmask;
+      DEBUGASSERT((priv->gat[gatidx] & gatmask) == gatmask);
+      priv->gat[gatidx] &= ~gatmask;
+
+      ngranules -= avail;
+      gatidx++;
+      gatbit     = 0;
     }
 
-  /* Handle the case where where all of the granules come from one entry */
+  /* Find the start of the free run, the granule following the last one
+   * allocated before granno, counting the leading zeros of the entries
+   * below it.
+   */
 
-  else
+  gatidx = granno >> 5;
+  gatbit = granno & 31;
+  curr   = gatbit ? priv->gat[gatidx] << (32 - gatbit) : 0;
+
+  while (curr == 0 && gatidx > 0)
     {
-      /* Mark bits in a single GAT entry */
+      gatidx--;
+      gatbit = 32;
+      curr   = priv->gat[gatidx];
+    }
 
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
+  runstart = curr ? (gatidx << 5) + gatbit - gran_clz(curr) : 0;
 
-      priv->gat[gatidx] |= gatmask;
-      return;
+  /* The run may now be long enough for any class */
+
+  for (i = 0; i < GRAN_NCLASSES; i++)
+    {
+      if (priv->hint[i] > runstart)
+        {
+          priv->hint[i] = runstart;
+        }
     }
 }
 
@@ -0,0 +1,354 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_CACHE_BATCH < 1 || CONFIG_MM_CACHE_BATCH > CONFIG_MM_CACHE_DEPTH
+#  error CONFIG_MM_CACHE_BATCH must be between 1 and CONFIG_MM_CACHE_DEPTH
+#endif
+
+/* The chunks of a cache are linked through the first word of their
+ * payload.
+ */
+
+#define MM_CACHE_NEXT(mem) (*(FAR void **)(mem))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_band
+ *
+ * Description:
+ *   Return the priority band of the running task.  Tasks of different
+ *   bands do not share caches, so that low priority tasks cannot drain the
+ *   caches used by the high priority ones.
+ *
+ *   The task priority is not available to the user-space heap of the
+ *   protected build, which only has one band.
+ *
+ ****************************************************************************/
+
+static inline int mm_cache_band(void)
+{
+#if CONFIG_MM_CACHE_NBANDS > 1 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+  return sched_self()->sched_priority * CONFIG_MM_CACHE_NBANDS /
+         (SCHED_PRIORITY_MAX + 1);
+#else
+  return 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_cache_drain
+ *
+ * Description:
+ *   Give a list of chunks back to the heap.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+static void mm_cache_drain(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR void *next;
+
+  for (; mem; mem = next)
+    {
+      next = MM_CACHE_NEXT(mem);
+      mm_freechunk(heap, mem);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_initialize
+ *
+ * Description:
+ *   Initialize the small-object caches of a heap.
+ *
+ ****************************************************************************/
+
+void mm_cache_initialize(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_cache, 0, sizeof(heap->mm_cache));
+  memset(&heap->mm_cacheinfo, 0, sizeof(struct mm_cacheinfo_s));
+}
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Allocate a chunk of 'size' bytes, allocated node included, from the
+ *   cache of the running task.  An empty cache is refilled with a batch of
+ *   chunks taken from the heap at once.
+ *
+ *   NULL is returned if the heap has no room left for the chunk.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *ret;
+  FAR void *mem;
+  irqstate_t flags;
+  int i;
+
+  DEBUGASSERT(size <= MM_CACHE_MAXCHUNK);
+  cache = &heap->mm_cache[mm_cache_band()][MM_CACHE_CLASS(size)];
+
+  flags = irqsave();
+  ret   = cache->head;
+  if (ret)
+    {
+      cache->head = MM_CACHE_NEXT(ret);
+      cache->count--;
+
+      heap->mm_cacheinfo.hits++;
+      heap->mm_cacheinfo.cached -= size;
+      irqrestore(flags);
+      return ret;
+    }
+
+  irqrestore(flags);
+
+  /* The cache is empty:  refill it */
+
+  mm_takesemaphore(heap);
+
+  ret = mm_allocchunk(heap, size);
+  if (ret)
+    {
+      for (i = 1; i < CONFIG_MM_CACHE_BATCH; i++)
+        {
+          mem = mm_allocchunk(heap, size);
+          if (!mem)
+            {
+              break;
+            }
+
+          flags = irqsave();
+          MM_CACHE_NEXT(mem) = cache->head;
+          cache->head = mem;
+          cache->count++;
+
+          heap->mm_cacheinfo.cached += size;
+          if (heap->mm_cacheinfo.cached > heap->mm_cacheinfo.maxcached)
+            {
+              heap->mm_cacheinfo.maxcached = heap->mm_cacheinfo.cached;
+            }
+
+          irqrestore(flags);
+        }
+
+      heap->mm_cacheinfo.refills++;
+    }
+
+  mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Put a chunk back into the cache of the running task.  A full cache
+ *   first gives a batch of chunks back to the heap.
+ *
+ *   false is returned if the chunk cannot be cached; it must then be given
+ *   back to the heap by the caller.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  FAR void *batch = NULL;
+  FAR void *last;
+  irqstate_t flags;
+  size_t size;
+  int i;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  size = node->size;
+
+  /* mm_memalign() may leave chunks that are not a multiple of the granule
+   * size.  They are not cached.
+   */
+
+  if (size > MM_CACHE_MAXCHUNK || (size & MM_GRAN_MASK) != 0)
+    {
+      return false;
+    }
+
+  cache = &heap->mm_cache[mm_cache_band()][MM_CACHE_CLASS(size)];
+
+  flags = irqsave();
+  if (cache->count >= CONFIG_MM_CACHE_DEPTH)
+    {
+      /* Detach the first CONFIG_MM_CACHE_BATCH chunks of the cache */
+
+      batch = cache->head;
+      for (last = batch, i = 1; i < CONFIG_MM_CACHE_BATCH; i++)
+        {
+          last = MM_CACHE_NEXT(last);
+        }
+
+      cache->head = MM_CACHE_NEXT(last);
+      cache->count -= CONFIG_MM_CACHE_BATCH;
+      MM_CACHE_NEXT(last) = NULL;
+
+      heap->mm_cacheinfo.drains++;
+      heap->mm_cacheinfo.cached -= CONFIG_MM_CACHE_BATCH * size;
+    }
+
+  MM_CACHE_NEXT(mem) = cache->head;
+  cache->head = mem;
+  cache->count++;
+
+  heap->mm_cacheinfo.cached += size;
+  if (heap->mm_cacheinfo.cached > heap->mm_cacheinfo.maxcached)
+    {
+      heap->mm_cacheinfo.maxcached = heap->mm_cacheinfo.cached;
+    }
+
+  irqrestore(flags);
+
+  if (batch)
+    {
+      mm_takesemaphore(heap);
+      mm_cache_drain(heap, batch);
+      mm_givesemaphore(heap);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Give all of the chunks held in the caches back to the heap, so that
+ *   they can be merged.  Returns the number of bytes given back.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+size_t mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_cache_s *cache;
+  FAR void *batch;
+  irqstate_t flags;
+  size_t flushed = 0;
+  int band;
+  int ndx;
+
+  for (band = 0; band < CONFIG_MM_CACHE_NBANDS; band++)
+    {
+      for (ndx = 0; ndx < MM_CACHE_NCLASSES; ndx++)
+        {
+          cache = &heap->mm_cache[band][ndx];
+
+          flags = irqsave();
+          batch = cache->head;
+          if (batch)
+            {
+              flushed += cache->count * ((ndx + 1) << MM_MIN_SHIFT);
+              heap->mm_cacheinfo.cached -=
+                cache->count * ((ndx + 1) << MM_MIN_SHIFT);
+              heap->mm_cacheinfo.drains++;
+
+              cache->head  = NULL;
+              cache->count = 0;
+            }
+
+          irqrestore(flags);
+          mm_cache_drain(heap, batch);
+        }
+    }
+
+  return flushed;
+}
+
+/****************************************************************************
+ * Name: mm_cacheinfo
+ *
+ * Description:
+ *   Return the statistics of the small-object caches of a heap.  The
+ *   chunks held in the caches are counted as allocated by mm_mallinfo().
+ *
+ ****************************************************************************/
+
+int mm_cacheinfo(FAR struct mm_heap_s *heap,
+                 FAR struct mm_cacheinfo_s *info)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(info);
+
+  flags = irqsave();
+  memcpy(info, &heap->mm_cacheinfo, sizeof(struct mm_cacheinfo_s));
+  irqrestore(flags);
+  return OK;
+}
+
+#endif /* CONFIG_MM_CACHE */
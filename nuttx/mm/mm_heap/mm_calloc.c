@@ -63,7 +63,7 @@ FAR void *mm_calloc(FAR struct mm_heap_s *heap, size_t n, size_t elem_size)
 
   if (n > 0 && elem_size > 0)
     {
-      ret = mm_zalloc(heap, n * elem_size);
+      ret = MM_TRACE_CALLER(mm_zalloc(heap, n * elem_size));
     }
 
   return ret;
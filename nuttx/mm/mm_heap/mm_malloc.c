@@ -73,84 +73,34 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_allocchunk
  *
  * Description:
- *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *   Take a free chunk of at least 'size' bytes, allocated node included,
+ *   and split off the remainder (if any).  The size must already
+ *   be aligned to the granule size.
  *
- *  8-byte alignment of the allocated data is assured.
+ * Assumptions:
+ *   The caller holds the MM semaphore.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+FAR void *mm_allocchunk(FAR struct mm_heap_s *heap, size_t size)
 {
   FAR struct mm_freenode_s *node;
-  void *ret = NULL;
-  int ndx;
-
-  /* Handle bad sizes */
-
-  if (size <= 0)
-    {
-      return NULL;
-    }
-
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
-   */
-
-  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
-
-  /* We need to hold the MM semaphore while we muck with the nodelist. */
-
-  mm_takesemaphore(heap);
-
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
-   */
-
-  if (size >= MM_MAX_CHUNK)
-    {
-      ndx = MM_NNODES-1;
-    }
-  else
-    {
-      /* Convert the request size into a nodelist index */
-
-      ndx = mm_size2ndx(size);
-    }
-
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
 
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < size;
-       node = node->flink);
-
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that is must be best fitting chunk
-   * available.
-   */
+  /* Find a free chunk large enough */
 
+  node = mm_findfreechunk(heap, size);
   if (node)
     {
       FAR struct mm_freenode_s *remainder;
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -190,10 +140,94 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       /* Handle the case of an exact size match */
 
       node->preceding |= MM_ALLOC_BIT;
-      ret = (void*)((char*)node + SIZEOF_MM_ALLOCNODE);
+
+#ifdef CONFIG_MM_TRACE
+      /* The chunk is not in use until it is tagged by its allocator */
+
+      MM_TRACE_TAG(node)->caller = NULL;
+#endif
+
+      return (void*)((char*)node + SIZEOF_MM_ALLOCNODE);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_mallocchunk
+ *
+ * Description:
+ *   Allocate a chunk of 'size' bytes, allocated node included.  The size
+ *   must already be aligned to the granule size.
+ *
+ ****************************************************************************/
+
+FAR void *mm_mallocchunk(FAR struct mm_heap_s *heap, size_t size)
+{
+  void *ret;
+
+#ifdef CONFIG_MM_CACHE
+  /* Small allocations are served from the caches when possible */
+
+  if (size <= MM_CACHE_MAXCHUNK)
+    {
+      ret = mm_cache_alloc(heap, size);
+      if (ret)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  /* We need to hold the MM semaphore while we muck with the nodelist. */
+
+  mm_takesemaphore(heap);
+  ret = mm_allocchunk(heap, size);
+
+#ifdef CONFIG_MM_CACHE
+  /* If the heap is exhausted, give back the memory held in the caches and
+   * try again.
+   */
+
+  if (!ret && mm_cache_flush(heap) > 0)
+    {
+      ret = mm_allocchunk(heap, size);
     }
+#endif
 
   mm_givesemaphore(heap);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  void *ret;
+
+  /* Handle bad sizes */
+
+  if (size <= 0)
+    {
+      return NULL;
+    }
+
+  /* Adjust the size to account for (1) the size of the allocated node,
+   * (2) the size of the trace tag, if any, and (3) to make sure that it is
+   * an even multiple of our granule size.
+   */
+
+  ret = mm_mallocchunk(heap, MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE +
+                                         MM_TRACE_TAGSIZE));
 
   /* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
    * to the SYSLOG.
@@ -214,5 +248,12 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_TRACE
+  if (ret)
+    {
+      mm_tracealloc(ret, size, __builtin_return_address(0));
+    }
+#endif
+
   return ret;
 }
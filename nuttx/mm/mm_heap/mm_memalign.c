@@ -76,6 +76,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   size_t alignedchunk;
   size_t mask = (size_t)(alignment - 1);
   size_t allocsize;
+#ifdef CONFIG_MM_TRACE
+  size_t reqsize;
+#endif
 
   /* If this requested alinement's less than or equal to the natural alignment
    * of malloc, then just let malloc do the work.
@@ -83,7 +86,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_MIN_CHUNK)
     {
-      return mm_malloc(heap, size);
+      return MM_TRACE_CALLER(mm_malloc(heap, size));
     }
 
   /* Adjust the size to account for (1) the size of the allocated node, (2)
@@ -95,15 +98,20 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    * alignment points within the allocated memory.
    *
    * NOTE:  These are sizes given to malloc and not chunk sizes. They do
-   * not include SIZEOF_MM_ALLOCNODE.
+   * not include SIZEOF_MM_ALLOCNODE.  They do include the trace tag, if
+   * any.
    */
 
-  size      = MM_ALIGN_UP(size);   /* Make multiples of our granule size */
+#ifdef CONFIG_MM_TRACE
+  reqsize   = size;
+#endif
+  size      = MM_ALIGN_UP(size + MM_TRACE_TAGSIZE);
   allocsize = size + 2*alignment;  /* Add double full alignment size */
 
   /* Then malloc that size */
 
-  rawchunk = (size_t)mm_malloc(heap, allocsize);
+  rawchunk = (size_t)mm_mallocchunk(heap, MM_ALIGN_UP(allocsize +
+                                                      SIZEOF_MM_ALLOCNODE));
   if (rawchunk == 0)
     {
       return NULL;
@@ -210,5 +218,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
   mm_givesemaphore(heap);
+
+#ifdef CONFIG_MM_TRACE
+  mm_tracealloc((FAR void *)alignedchunk, reqsize,
+                __builtin_return_address(0));
+#endif
+
   return (FAR void*)alignedchunk;
 }
@@ -91,12 +91,16 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   size_t prevsize = 0;
   size_t nextsize = 0;
   FAR void *newmem;
+#ifdef CONFIG_MM_TRACE
+  FAR void *caller = __builtin_return_address(0);
+  size_t reqsize = size;
+#endif
 
   /* If oldmem is NULL, then realloc is equivalent to malloc */
 
   if (!oldmem)
     {
-      return mm_malloc(heap, size);
+      return MM_TRACE_CALLER(mm_malloc(heap, size));
     }
 
   /* If size is zero, then realloc is equivalent to free */
@@ -107,11 +111,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       return NULL;
     }
 
-  /* Adjust the size to account for (1) the size of the allocated node and
-   * (2) to make sure that it is an even multiple of our granule size.
+  /* Adjust the size to account for (1) the size of the allocated node,
+   * (2) the size of the trace tag, if any, and (3) to make sure that it is
+   * an even multiple of our granule size.
    */
 
-  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE + MM_TRACE_TAGSIZE);
 
   /* Map the memory chunk into an allocated node structure */
 
@@ -138,6 +143,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       /* Then return the original address */
 
       mm_givesemaphore(heap);
+
+#ifdef CONFIG_MM_TRACE
+      mm_tracefree(oldmem, caller);
+      mm_tracealloc(oldmem, reqsize, caller);
+#endif
+
       return oldmem;
     }
 
@@ -227,16 +238,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -296,16 +300,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
           andbeyond = (FAR struct mm_allocnode_s*)((char*)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -337,6 +334,12 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         }
 
       mm_givesemaphore(heap);
+
+#ifdef CONFIG_MM_TRACE
+      mm_tracefree(oldmem, caller);
+      mm_tracealloc(newmem, reqsize, caller);
+#endif
+
       return newmem;
     }
 
@@ -349,11 +352,15 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
        */
 
       mm_givesemaphore(heap);
-      newmem = (FAR void*)mm_malloc(heap, size);
+      newmem = (FAR void*)mm_mallocchunk(heap, size);
       if (newmem)
         {
           memcpy(newmem, oldmem, oldsize);
           mm_free(heap, oldmem);
+
+#ifdef CONFIG_MM_TRACE
+          mm_tracealloc(newmem, reqsize, caller);
+#endif
         }
 
       return newmem;
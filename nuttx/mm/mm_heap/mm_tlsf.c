@@ -0,0 +1,276 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if MM_TLSF_FLCOUNT > 32
+#  error Too many first level ranges for the first level bitmap
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_ffs and mm_tlsf_fls
+ *
+ * Description:
+ *   Return the index of the least (ffs) or most (fls) significant bit set
+ *   in a non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef __GNUC__
+#  define mm_tlsf_ffs(value) __builtin_ctz(value)
+#  define mm_tlsf_fls(value) (31 - __builtin_clz(value))
+#else
+static inline int mm_tlsf_ffs(uint32_t value)
+{
+  int bit = 0;
+
+  while ((value & 1) == 0)
+    {
+      value >>= 1;
+      bit++;
+    }
+
+  return bit;
+}
+
+static inline int mm_tlsf_fls(uint32_t value)
+{
+  int bit = 31;
+
+  while ((value & 0x80000000) == 0)
+    {
+      value <<= 1;
+      bit--;
+    }
+
+  return bit;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Return the first and second level indexes of the free list holding the
+ *   chunks of a given size.
+ *
+ ****************************************************************************/
+
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < MM_TLSF_SMALL)
+    {
+      *fl = 0;
+      *sl = size >> MM_MIN_SHIFT;
+    }
+  else
+    {
+      msb = mm_tlsf_fls(size);
+      *fl = msb - MM_TLSF_FLSHIFT + 1;
+      *sl = (size >> (msb - MM_TLSF_SLSHIFT)) - MM_TLSF_SLCOUNT;
+
+      if (*fl >= MM_TLSF_FLCOUNT)
+        {
+          *fl = MM_TLSF_FLCOUNT - 1;
+          *sl = MM_TLSF_SLCOUNT - 1;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of its free list.  It is assumed that the
+ *   caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->flink = head;
+  node->blink = NULL;
+  if (head)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slbitmap[fl]    |= (uint32_t)1 << sl;
+  heap->mm_flbitmap        |= (uint32_t)1 << fl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from its free list.  The size of the chunk must not
+ *   have changed since it was added.  It is assumed that the caller holds
+ *   the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* This is the head of its list */
+
+      mm_tlsf_mapping(node->size, &fl, &sl);
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+      heap->mm_freelist[fl][sl] = node->flink;
+      if (!node->flink)
+        {
+          heap->mm_slbitmap[fl] &= ~((uint32_t)1 << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Return a free chunk of at least 'size' bytes, NULL if there is none.
+ *   The chunk is not removed from its free list.  It is assumed that the
+ *   caller holds the mm semaphore
+ *
+ *   The size is rounded up to the next list boundary, so that any chunk of
+ *   the first non-empty list from there fits:  the search takes constant
+ *   time, at the cost of ignoring chunks of the rounded range that would
+ *   have fit.  Only requests of MM_MAX_CHUNK and above search a list.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t bitmap;
+  int fl;
+  int sl;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      /* The chunks of the last list are not sorted by size:  search it */
+
+      mm_tlsf_mapping(size, &fl, &sl);
+      for (node = heap->mm_freelist[fl][sl];
+           node && node->size < size;
+           node = node->flink);
+
+      if (node || ++sl >= MM_TLSF_SLCOUNT)
+        {
+          return node;
+        }
+    }
+  else
+    {
+      if (size >= MM_TLSF_SMALL)
+        {
+          size += ((size_t)1 << (mm_tlsf_fls(size) - MM_TLSF_SLSHIFT)) - 1;
+        }
+
+      mm_tlsf_mapping(size, &fl, &sl);
+    }
+
+  /* Look for a non-empty list in the same first level range, then for the
+   * first non-empty list of the next non-empty range.
+   */
+
+  bitmap = heap->mm_slbitmap[fl] & ~(((uint32_t)1 << sl) - 1);
+  if (bitmap == 0)
+    {
+      bitmap = heap->mm_flbitmap & ~(((uint32_t)2 << fl) - 1);
+      if (bitmap == 0)
+        {
+          return NULL;
+        }
+
+      fl     = mm_tlsf_ffs(bitmap);
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  sl = mm_tlsf_ffs(bitmap);
+  return heap->mm_freelist[fl][sl];
+}
+
+#endif /* CONFIG_MM_TLSF */
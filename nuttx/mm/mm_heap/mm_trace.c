@@ -0,0 +1,222 @@
+/****************************************************************************
+ * mm/mm_heap/mm_trace.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TRACE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_TRACE_NEVENTS   CONFIG_MM_TRACE_NEVENTS
+
+/* mm_tracecaller() looks for the allocation to re-attribute among this
+ * number of most recent events.
+ */
+
+#define MM_TRACE_LOOKBACK  4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The ring of events, and the number of events ever logged in it */
+
+static struct mm_traceevent_s g_mmtrace[MM_TRACE_NEVENTS];
+static uint32_t g_mmtracecount;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tracelog
+ *
+ * Description:
+ *   Log an event in the ring, overwriting the oldest one when it is full.
+ *
+ ****************************************************************************/
+
+static void mm_tracelog(FAR void *mem, size_t size, FAR void *caller,
+                        pid_t pid, uint32_t time)
+{
+  FAR struct mm_traceevent_s *event;
+  irqstate_t flags;
+
+  flags = irqsave();
+  event = &g_mmtrace[g_mmtracecount++ % MM_TRACE_NEVENTS];
+
+  event->time   = time;
+  event->caller = caller;
+  event->mem    = mem;
+  event->size   = size;
+  event->pid    = pid;
+  irqrestore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tracealloc
+ *
+ * Description:
+ *   Tag a newly allocated chunk and log its allocation.
+ *
+ ****************************************************************************/
+
+void mm_tracealloc(FAR void *mem, size_t size, FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_tracetag_s *tag;
+  uint32_t time = clock_systimer();
+  pid_t pid = getpid();
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  tag  = MM_TRACE_TAG(node);
+
+  tag->caller = caller;
+  tag->pid    = pid;
+  tag->stamp  = time / CLK_TCK;
+
+  mm_tracelog(mem, size, caller, pid, time);
+}
+
+/****************************************************************************
+ * Name: mm_tracefree
+ *
+ * Description:
+ *   Log the release of a chunk.
+ *
+ ****************************************************************************/
+
+void mm_tracefree(FAR void *mem, FAR void *caller)
+{
+  mm_tracelog(mem, 0, caller, getpid(), clock_systimer());
+}
+
+/****************************************************************************
+ * Name: mm_tracecaller
+ *
+ * Description:
+ *   Attribute a recent allocation to another caller.  This is how the
+ *   allocation wrappers, such as malloc(), report the allocations on
+ *   behalf of their own caller.  'mem' is returned, and may be NULL.
+ *
+ ****************************************************************************/
+
+FAR void *mm_tracecaller(FAR void *mem, FAR void *caller)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_traceevent_s *event;
+  irqstate_t flags;
+  uint32_t index;
+  int i;
+
+  if (mem)
+    {
+      node = (FAR struct mm_allocnode_s *)
+        ((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+      MM_TRACE_TAG(node)->caller = caller;
+
+      flags = irqsave();
+      for (i = 0, index = g_mmtracecount;
+           i < MM_TRACE_LOOKBACK && index > 0;
+           i++, index--)
+        {
+          event = &g_mmtrace[(index - 1) % MM_TRACE_NEVENTS];
+          if (event->mem == mem && event->size != 0)
+            {
+              event->caller = caller;
+              break;
+            }
+        }
+
+      irqrestore(flags);
+    }
+
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_tracedump
+ *
+ * Description:
+ *   Copy up to 'nevents' of the most recent events, oldest first.  Returns
+ *   the number of events copied.
+ *
+ ****************************************************************************/
+
+int mm_tracedump(FAR struct mm_traceevent_s *events, int nevents)
+{
+  irqstate_t flags;
+  uint32_t index;
+  int i;
+
+  flags = irqsave();
+
+  if (nevents > MM_TRACE_NEVENTS)
+    {
+      nevents = MM_TRACE_NEVENTS;
+    }
+
+  if ((uint32_t)nevents > g_mmtracecount)
+    {
+      nevents = g_mmtracecount;
+    }
+
+  index = g_mmtracecount - nevents;
+  for (i = 0; i < nevents; i++, index++)
+    {
+      events[i] = g_mmtrace[index % MM_TRACE_NEVENTS];
+    }
+
+  irqrestore(flags);
+  return nevents;
+}
+
+#endif /* CONFIG_MM_TRACE */
@@ -61,7 +61,7 @@
 
 FAR void *mm_zalloc(FAR struct mm_heap_s *heap, size_t size)
 {
-  FAR void *alloc = mm_malloc(heap, size);
+  FAR void *alloc = MM_TRACE_CALLER(mm_malloc(heap, size));
   if (alloc)
     {
        memset(alloc, 0, size);
@@ -80,7 +80,7 @@
 
 FAR void *calloc(size_t n, size_t elem_size)
 {
-  return mm_calloc(USR_HEAP, n, elem_size);
+  return MM_TRACE_CALLER(mm_calloc(USR_HEAP, n, elem_size));
 }
 
 #endif /* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
@@ -132,9 +132,9 @@ FAR void *malloc(size_t size)
     }
   while (mem == NULL);
 
-  return mem;
+  return MM_TRACE_CALLER(mem);
 #else
-  return mm_malloc(USR_HEAP, size);
+  return MM_TRACE_CALLER(mm_malloc(USR_HEAP, size));
 #endif
 }
 
@@ -89,7 +89,7 @@
 
 FAR void *memalign(size_t alignment, size_t size)
 {
-  return mm_memalign(USR_HEAP, alignment, size);
+  return MM_TRACE_CALLER(mm_memalign(USR_HEAP, alignment, size));
 }
 
 #endif /* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
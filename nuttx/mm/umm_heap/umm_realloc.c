@@ -91,7 +91,7 @@
 
 FAR void *realloc(FAR void *oldmem, size_t size)
 {
-  return mm_realloc(USR_HEAP, oldmem, size);
+  return MM_TRACE_CALLER(mm_realloc(USR_HEAP, oldmem, size));
 }
 
 #endif /* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
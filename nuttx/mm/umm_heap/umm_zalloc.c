@@ -96,12 +96,12 @@ FAR void *zalloc(size_t size)
        memset(alloc, 0, size);
     }
 
-  return alloc;
+  return MM_TRACE_CALLER(alloc);
 
 #else
   /* Use mm_zalloc() becuase it implements the clear */
 
-  return mm_zalloc(USR_HEAP, size);
+  return MM_TRACE_CALLER(mm_zalloc(USR_HEAP, size));
 #endif
 }
 
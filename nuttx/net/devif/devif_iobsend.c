@@ -99,7 +99,12 @@
 void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                     unsigned int len, unsigned int offset)
 {
+#ifdef CONFIG_NET_TCP_LARGESEND
+  DEBUGASSERT(dev && len > 0 &&
+              (len < CONFIG_NET_BUFSIZE || len <= dev->d_largesend));
+#else
   DEBUGASSERT(dev && len > 0 && len < CONFIG_NET_BUFSIZE);
+#endif
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * net/devif/devif_ring.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_RINGS)
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a ring poll, shared with the poll callback */
+
+struct devif_ringpoll_s
+{
+  FAR struct netdev_ring_s *txring; /* The transmit ring being filled */
+  devif_poll_callback_t callback;   /* The driver callback */
+  int nframes;                      /* Frames queued by this pass */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Polls are serialized by the network lock */
+
+static struct devif_ringpoll_s g_ringpoll;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: devif_ring_txpoll
+ *
+ * Description:
+ *   The poll callback of devif_ring_poll() and devif_ring_timer():  let the
+ *   driver complete the outgoing frame, if any, queue it in the transmit
+ *   ring and give the next free transmit buffer to the next connection.
+ *
+ * Returned Value:
+ *   Non-zero to stop the poll when the transmit ring is full or when the
+ *   driver callback asks so.
+ *
+ ****************************************************************************/
+
+static int devif_ring_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_ring_s *txring = g_ringpoll.txring;
+  FAR struct netdev_desc_s *desc;
+  int ret = 0;
+
+  if (dev->d_len > 0)
+    {
+      /* Let the driver complete the frame, with arp_out() for example */
+
+      if (g_ringpoll.callback)
+        {
+          ret = g_ringpoll.callback(dev);
+        }
+
+      if (dev->d_len > 0)
+        {
+          desc         = NETDEV_RING_HEAD(txring);
+          desc->nd_len = dev->d_len;
+#ifdef CONFIG_NET_TCP_LARGESEND
+          desc->nd_segmss = dev->d_segmss;
+#endif
+          txring->nr_head++;
+          g_ringpoll.nframes++;
+        }
+
+      dev->d_len = 0;
+#ifdef CONFIG_NET_TCP_LARGESEND
+      dev->d_segmss = 0;
+#endif
+
+      if (NETDEV_RING_FULL(txring))
+        {
+          return 1;
+        }
+
+      dev->d_buf = NETDEV_RING_HEAD(txring)->nd_buf;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Function: devif_ring_run
+ *
+ * Description:
+ *   Poll the connections, once with the timer action if hsec is non-zero,
+ *   then again as long as they produce frames and there are free transmit
+ *   descriptors.
+ *
+ ****************************************************************************/
+
+static int devif_ring_run(FAR struct net_driver_s *dev,
+                          FAR struct netdev_ring_s *txring,
+                          devif_poll_callback_t callback, int hsec)
+{
+  FAR uint8_t *buf = dev->d_buf;
+  int nframes = 0;
+
+  while (!NETDEV_RING_FULL(txring))
+    {
+      g_ringpoll.txring   = txring;
+      g_ringpoll.callback = callback;
+      g_ringpoll.nframes  = 0;
+
+      dev->d_buf = NETDEV_RING_HEAD(txring)->nd_buf;
+      dev->d_len = 0;
+
+      if (hsec > 0)
+        {
+          (void)devif_timer(dev, devif_ring_txpoll, hsec);
+          hsec = 0;
+        }
+      else
+        {
+          (void)devif_poll(dev, devif_ring_txpoll);
+        }
+
+      /* Stop when a whole pass had nothing more to send */
+
+      if (g_ringpoll.nframes == 0)
+        {
+          break;
+        }
+
+      nframes += g_ringpoll.nframes;
+    }
+
+  dev->d_buf = buf;
+  dev->d_len = 0;
+  return nframes;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: devif_ring_poll and devif_ring_timer
+ *
+ * Description:
+ *   Like devif_poll() and devif_timer(), but queue the outgoing frames in
+ *   the free descriptors of a transmit ring rather than in a single d_buf,
+ *   and poll the connections again as long as they have more to send and
+ *   there is room in the ring.  A connection with a lot of data to send
+ *   may so queue several frames at once.
+ *
+ *   The callback is called for each outgoing frame before it is queued,
+ *   for the link layer (arp_out() with Ethernet).  It may discard the
+ *   frame by clearing d_len, and stop the poll by returning non-zero.
+ *   Transmitting the queued frames is left to the driver.
+ *
+ * Returned Value:
+ *   The number of frames queued in the transmit ring.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int devif_ring_poll(FAR struct net_driver_s *dev,
+                    FAR struct netdev_ring_s *txring,
+                    devif_poll_callback_t callback)
+{
+  return devif_ring_run(dev, txring, callback, 0);
+}
+
+int devif_ring_timer(FAR struct net_driver_s *dev,
+                     FAR struct netdev_ring_s *txring,
+                     devif_poll_callback_t callback, int hsec)
+{
+  return devif_ring_run(dev, txring, callback, hsec);
+}
+
+/****************************************************************************
+ * Function: devif_ring_input
+ *
+ * Description:
+ *   Process a burst of received frames, from the tail to the head of a
+ *   receive ring.  The callback is called for each frame with d_buf and
+ *   d_len describing it, and does the link layer part of the input
+ *   (arp_ipin(), devif_input() and arp_out(), or arp_arpin(), with
+ *   Ethernet).
+ *
+ *   If the callback leaves a reply in d_buf, the buffer of the received
+ *   frame is swapped with the buffer of the next free descriptor of the
+ *   transmit ring and the reply is queued there without copy.  The reply
+ *   is dropped if the transmit ring is full.  The driver must thus use the
+ *   buffers found in the receive descriptors when it refills them.
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int devif_ring_input(FAR struct net_driver_s *dev,
+                     FAR struct netdev_ring_s *rxring,
+                     FAR struct netdev_ring_s *txring,
+                     devif_poll_callback_t callback)
+{
+  FAR uint8_t *buf = dev->d_buf;
+  FAR struct netdev_desc_s *rxdesc;
+  FAR struct netdev_desc_s *txdesc;
+  int nframes = 0;
+
+  while (!NETDEV_RING_EMPTY(rxring))
+    {
+      rxdesc     = NETDEV_RING_TAIL(rxring);
+      dev->d_buf = rxdesc->nd_buf;
+      dev->d_len = rxdesc->nd_len;
+
+      (void)callback(dev);
+
+      if (dev->d_len > 0)
+        {
+          if (!NETDEV_RING_FULL(txring))
+            {
+              txdesc         = NETDEV_RING_HEAD(txring);
+              rxdesc->nd_buf = txdesc->nd_buf;
+              txdesc->nd_buf = dev->d_buf;
+              txdesc->nd_len = dev->d_len;
+#ifdef CONFIG_NET_TCP_LARGESEND
+              txdesc->nd_segmss = dev->d_segmss;
+#endif
+              txring->nr_head++;
+            }
+          else
+            {
+              nllvdbg("Dropped a reply, the TX ring is full\n");
+            }
+        }
+
+#ifdef CONFIG_NET_TCP_LARGESEND
+      dev->d_segmss = 0;
+#endif
+
+      rxring->nr_tail++;
+      nframes++;
+    }
+
+  dev->d_buf = buf;
+  dev->d_len = 0;
+  return nframes;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_RINGS */
@@ -161,14 +161,10 @@ void icmp_input(FAR struct net_driver_s *dev)
        * checksum for the change of type
        */
 
-      if (picmp->icmpchksum >= HTONS(0xffff - (ICMP_ECHO_REQUEST << 8)))
-        {
-          picmp->icmpchksum += HTONS(ICMP_ECHO_REQUEST << 8) + 1;
-        }
-      else
-        {
-          picmp->icmpchksum += HTONS(ICMP_ECHO_REQUEST << 8);
-        }
+      picmp->icmpchksum =
+        net_chksum_update(picmp->icmpchksum,
+                          HTONS(ICMP_ECHO_REQUEST << 8 | picmp->icode),
+                          HTONS(ICMP_ECHO_REPLY << 8 | picmp->icode));
 #endif
 
       nllvdbg("Outgoing ICMP packet length: %d (%d)\n",
@@ -109,4 +109,20 @@ FAR struct iob_qentry_s *iob_alloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_unborrow
+ *
+ * Description:
+ *   Release the external buffer referenced by a borrowed I/O buffer.  The
+ *   I/O buffer is left empty, using its own payload.  Nothing is done if
+ *   the I/O buffer is not borrowed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_BORROWED
+void iob_unborrow(FAR struct iob_s *iob);
+#else
+#  define iob_unborrow(iob)
+#endif
+
 #endif /* __NET_IOB_IOB_H */
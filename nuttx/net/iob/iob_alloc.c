@@ -147,6 +147,9 @@ static FAR struct iob_s *iob_tryalloc(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_IOB_BORROWED
+          iob->io_buf    = NULL; /* Uses its own payload */
+#endif
           return iob;
         }
     }
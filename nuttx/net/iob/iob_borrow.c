@@ -0,0 +1,136 @@
+/****************************************************************************
+ * net/iob/iob_borrow.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#if defined(CONFIG_DEBUG) && defined(CONFIG_IOB_DEBUG)
+/* Force debug output (from this file only) */
+
+#  undef  CONFIG_DEBUG_NET
+#  define CONFIG_DEBUG_NET 1
+#endif
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_BORROWED
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_borrow
+ *
+ * Description:
+ *   Make an I/O buffer refer to 'len' bytes of external data at 'buf'
+ *   instead of its own payload.  Any data previously held by the I/O
+ *   buffer is discarded and a previously borrowed buffer is released.
+ *   The I/O buffer must not be part of a chain.
+ *
+ *   The data is not copied and must not be modified until 'release' is
+ *   called (with 'arg') when the I/O buffer is freed or borrows another
+ *   buffer.  'release' may be NULL if nothing needs to be done.
+ *
+ ****************************************************************************/
+
+int iob_borrow(FAR struct iob_s *iob, FAR const void *buf, unsigned int len,
+               iob_release_t release, FAR void *arg)
+{
+  nllvdbg("iob=%p buf=%p len=%u\n", iob, buf, len);
+  DEBUGASSERT(iob && iob->io_flink == NULL && buf);
+
+  /* The length must be representable in the I/O buffer */
+
+  if (len > UINT16_MAX)
+    {
+      ndbg("ERROR: Borrowed buffer is too large: %u\n", len);
+      return -EINVAL;
+    }
+
+  /* Return any buffer that was previously borrowed */
+
+  iob_unborrow(iob);
+
+  /* And refer to the new one */
+
+  iob->io_buf     = (FAR uint8_t *)buf;
+  iob->io_release = release;
+  iob->io_arg     = arg;
+  iob->io_len     = len;
+  iob->io_offset  = 0;
+  iob->io_pktlen  = len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iob_unborrow
+ *
+ * Description:
+ *   Release the external buffer referenced by a borrowed I/O buffer.  The
+ *   I/O buffer is left empty, using its own payload.  Nothing is done if
+ *   the I/O buffer is not borrowed.
+ *
+ ****************************************************************************/
+
+void iob_unborrow(FAR struct iob_s *iob)
+{
+  if (iob->io_buf != NULL)
+    {
+      nllvdbg("iob=%p buf=%p\n", iob, iob->io_buf);
+
+      if (iob->io_release != NULL)
+        {
+          iob->io_release(iob->io_arg);
+        }
+
+      iob->io_buf     = NULL;
+      iob->io_release = NULL;
+      iob->io_arg     = NULL;
+      iob->io_len     = 0;
+      iob->io_offset  = 0;
+    }
+}
+
+#endif /* CONFIG_IOB_BORROWED */
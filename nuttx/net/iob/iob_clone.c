@@ -89,7 +89,7 @@
 
 int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
 {
-  FAR uint8_t *src;
+  FAR const uint8_t *src;
   FAR uint8_t *dest;
   unsigned int ncopy;
   unsigned int avail1;
@@ -124,7 +124,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        * from this address.
        */
 
-      src    = &iob1->io_data[iob1->io_offset + offset1];
+      src    = IOB_DATA(iob1) + offset1;
       avail1 = iob1->io_len - offset1;
 
       /* Get the destination I/O buffer pointer and the number of bytes to
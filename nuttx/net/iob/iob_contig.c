@@ -117,6 +117,17 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
 
   else if (len <= iob->io_pktlen)
     {
+#ifdef CONFIG_IOB_BORROWED
+      /* Borrowed data cannot be moved or appended to */
+
+      if (IOB_ISBORROWED(iob))
+        {
+          ndbg("ERROR: Borrowed head len=%u < requested len=%u\n",
+               iob->io_len, len);
+          return -EPERM;
+        }
+
+#endif
       /* Yes.. First eliminate any leading offset */
 
       if (iob->io_offset > 0)
@@ -138,8 +149,7 @@ int iob_contig(FAR struct iob_s *iob, unsigned int len)
 
           ncopy = len - iob->io_len;
           ncopy = MIN(ncopy, next->io_len);
-          memcpy(&iob->io_data[iob->io_len],
-                 &next->io_data[next->io_offset], ncopy);
+          memcpy(&iob->io_data[iob->io_len], IOB_DATA(next), ncopy);
 
           /* Adjust counts and offsets */
 
@@ -124,6 +124,35 @@ int iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
     {
       next = iob->io_flink;
 
+#ifdef CONFIG_IOB_BORROWED
+      /* Borrowed data is read-only.  Data may only be added after it. */
+
+      if (IOB_ISBORROWED(iob))
+        {
+          if (offset < iob->io_len)
+            {
+              ndbg("ERROR: Cannot overwrite borrowed data\n");
+              return -EPERM;
+            }
+
+          if (!next)
+            {
+              next = iob_alloc(throttled);
+              if (next == NULL)
+                {
+                  ndbg("ERROR: Failed to allocate I/O buffer\n");
+                  return -ENOMEM;
+                }
+
+              iob->io_flink = next;
+            }
+
+          iob = next;
+          offset = 0;
+          continue;
+        }
+#endif
+
       /* Get the destination I/O buffer address and the amount of data
        * available from that address.
        */
@@ -123,6 +123,10 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
                next, next->io_pktlen, next->io_len);
     }
 
+  /* Return the external buffer if this I/O buffer was borrowed */
+
+  iob_unborrow(iob);
+
   /* Free the I/O buffer by adding it to the head of the free list. We don't
    * know what context we are called from so we use extreme measures to
    * protect the free list:  We disable interrupts very briefly.
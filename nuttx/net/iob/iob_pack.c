@@ -110,6 +110,14 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
     {
       next = iob->io_flink;
 
+      /* Borrowed data cannot be moved or appended to.  Leave it in place. */
+
+      if (IOB_ISBORROWED(iob))
+        {
+          iob = next;
+          continue;
+        }
+
       /* Eliminate the data offset in this entry */
 
       if (iob->io_offset > 0)
@@ -138,9 +146,7 @@ FAR struct iob_s *iob_pack(FAR struct iob_s *iob)
             {
               /* Copy the data from the next into the current I/O buffer iob */
 
-              memcpy(&iob->io_data[iob->io_len],
-                     &next->io_data[next->io_offset],
-                     ncopy);
+              memcpy(&iob->io_data[iob->io_len], IOB_DATA(next), ncopy);
 
               /* Adjust lengths and offsets */
 
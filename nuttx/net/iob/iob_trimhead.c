@@ -125,6 +125,7 @@ FAR struct iob_s *iob_trimhead(FAR struct iob_s *iob, unsigned int trimlen)
                    */
 
                   DEBUGASSERT(pktlen == 0);
+                  iob_unborrow(iob);
                   iob->io_len    = 0;
                   iob->io_offset = 0;
                   break;
@@ -58,6 +58,8 @@
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/net/iob.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -79,6 +81,14 @@
 
 #define TCPBUF ((struct tcp_iphdr_s *)&dev->d_buf[NET_LL_HDRLEN])
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/* The largest part of a memory mapped file that one borrowed I/O buffer
+ * can refer to.
+ */
+
+#  define SENDFILE_MAXBORROW UINT16_MAX
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,6 +112,11 @@ struct sendfile_s
 #ifdef CONFIG_NET_SOCKOPTS
   uint32_t           snd_time;    /* Last send time for determining timeout */
 #endif
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  FAR const uint8_t *snd_map;     /* Memory mapped file data (or NULL) */
+  FAR struct iob_s  *snd_iob;     /* I/O buffer borrowing the mapped data */
+  off_t              snd_iobpos;  /* File offset of the borrowed data */
+#endif
 };
 
 /****************************************************************************
@@ -148,6 +163,132 @@ static inline int sendfile_timeout(FAR struct sendfile_s *pstate)
 }
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/****************************************************************************
+ * Function: sendfile_map
+ *
+ * Description:
+ *   Check if the data to be sent can be accessed directly in memory.  If
+ *   so, set up to send it with a borrowed I/O buffer instead of reading it
+ *   through the file system.
+ *
+ * Parameters:
+ *   pstate   send state structure
+ *
+ * Returned Value:
+ *   None.  The data is read from the file as before if it cannot be
+ *   mapped.
+ *
+ * Assumptions:
+ *   Running at the user level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static void sendfile_map(FAR struct sendfile_s *pstate)
+{
+  FAR struct file *filep = pstate->snd_file;
+  FAR struct inode *inode = filep->f_inode;
+  FAR void *addr = NULL;
+  off_t pos;
+  off_t size;
+  int ret;
+
+  /* Does the file system support the FIOC_MMAP ioctl for this file? */
+
+  if (!inode || !inode->u.i_ops || !inode->u.i_ops->ioctl)
+    {
+      return;
+    }
+
+  ret = (int)inode->u.i_ops->ioctl(filep, FIOC_MMAP,
+                                   (unsigned long)((uintptr_t)&addr));
+  if (ret < 0 || addr == NULL)
+    {
+      return;
+    }
+
+  /* Only use the mapping if all of the data to be sent lies within the
+   * file.  Otherwise, let the file system deal with the short file.
+   */
+
+  pos  = file_seek(filep, 0, SEEK_CUR);
+  size = file_seek(filep, 0, SEEK_END);
+  (void)file_seek(filep, pos, SEEK_SET);
+
+  if (pos < 0 || size < 0 ||
+      pstate->snd_foffset + (off_t)pstate->snd_flen > size)
+    {
+      return;
+    }
+
+  /* Get an I/O buffer that will borrow the mapped data */
+
+  pstate->snd_iob = iob_alloc(false);
+  if (pstate->snd_iob != NULL)
+    {
+      nvdbg("Sending from mapped file at %p\n", addr);
+      pstate->snd_map = (FAR const uint8_t *)addr;
+    }
+}
+#endif /* CONFIG_NET_SENDFILE_ZEROCOPY */
+
+/****************************************************************************
+ * Function: sendfile_borrow
+ *
+ * Description:
+ *   Make sure that the borrowed I/O buffer refers to the 'sndlen' bytes of
+ *   mapped file data that will be sent next.
+ *
+ * Parameters:
+ *   pstate   send state structure
+ *   sndlen   The number of bytes to be sent
+ *
+ * Returned Value:
+ *   The offset of the data in the borrowed I/O buffer on success; a
+ *   negated errno value on failure.
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+static int sendfile_borrow(FAR struct sendfile_s *pstate, uint32_t sndlen)
+{
+  off_t pos = pstate->snd_foffset + pstate->snd_sent;
+  size_t len;
+  int ret;
+
+  /* Is the data already referenced by the borrowed I/O buffer?  It will
+   * not be after the current part of the file has been sent or when data
+   * has to be retransmitted.
+   */
+
+  if (pos < pstate->snd_iobpos ||
+      pos + sndlen > pstate->snd_iobpos + pstate->snd_iob->io_len)
+    {
+      /* No.. borrow the next part of the file */
+
+      len = pstate->snd_flen - pstate->snd_sent;
+      if (len > SENDFILE_MAXBORROW)
+        {
+          len = SENDFILE_MAXBORROW;
+        }
+
+      ret = iob_borrow(pstate->snd_iob, &pstate->snd_map[pos], len,
+                       NULL, NULL);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      pstate->snd_iobpos = pos;
+    }
+
+  return (int)(pos - pstate->snd_iobpos);
+}
+#endif /* CONFIG_NET_SENDFILE_ZEROCOPY */
+
 static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
                               FAR void *pvpriv, uint16_t flags)
 {
@@ -279,23 +420,43 @@ static uint16_t sendfile_interrupt(FAR struct net_driver_s *dev, FAR void *pvcon
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+          if (pstate->snd_map != NULL)
             {
-              int errcode = errno;
-              nlldbg("failed to lseek: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
-            }
+              /* Send directly from the mapped file data */
 
-          ret = file_read(pstate->snd_file, dev->d_snddata, sndlen);
-          if (ret < 0)
+              ret = sendfile_borrow(pstate, sndlen);
+              if (ret < 0)
+                {
+                  nlldbg("failed to borrow file data: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              devif_iob_send(dev, pstate->snd_iob, sndlen, ret);
+            }
+          else
+#endif
             {
-              int errcode = errno;
-              nlldbg("failed to read from input file: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  int errcode = errno;
+                  nlldbg("failed to lseek: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_snddata, sndlen);
+              if (ret < 0)
+                {
+                  int errcode = errno;
+                  nlldbg("failed to read from input file: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -308,7 +469,7 @@ static uint16_t sendfile_interrupt(FAR struct net_driver_s *dev, FAR void *pvcon
            */
 
           seqno = pstate->snd_sent + pstate->snd_isn;
-          nllvdbg("SEND: sndseq %08x->%08x len: %d\n", conn->sndseq, seqno, ret);
+          nllvdbg("SEND: sndseq %08x->%08x len: %d\n", conn->sndseq, seqno, sndlen);
 
           tcp_setsequence(conn->sndseq, seqno);
 
@@ -511,6 +672,12 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Send directly from memory if the file can be mapped */
+
+  sendfile_map(&state);
+#endif
+
   /* Allocate resources to receive a callback */
 
   state.snd_datacb = tcp_callback_alloc(conn);
@@ -580,6 +747,14 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   tcp_callback_free(conn, state.snd_datacb);
 
  errout_locked:
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Return the borrowed I/O buffer (and the mapped file data) */
+
+  if (state.snd_iob != NULL)
+    {
+      iob_free(state.snd_iob);
+    }
+#endif
 
   sem_destroy(&state. snd_sem);
   net_unlock(save);
@@ -65,6 +65,12 @@
 
 #define tcp_mss(conn)              ((conn)->mss)
 
+/* Hash of a port number (in either byte order) into the connection and
+ * listener hash tables.
+ */
+
+#define TCP_PORTHASH(p)  ((((p) >> 8) ^ (p)) % CONFIG_NET_TCP_NHASH)
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 /* TCP write buffer access macros */
 
@@ -132,6 +138,18 @@ struct tcp_conn_s
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
 
+  /* Hash chains
+   *
+   *   hnext - The next connection in the same bucket of the active
+   *     connections hashed by port numbers or, for a listener, of the
+   *     listeners hashed by local port number.
+   *   pnext - The next connection in the same bucket of the connections
+   *     bound to a local port, hashed by local port number.
+   */
+
+  FAR struct tcp_conn_s *hnext;
+  FAR struct tcp_conn_s *pnext;
+
   /* Read-ahead buffering.
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
@@ -80,6 +80,15 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connections of the active list, hashed by local and remote port
+ * numbers, and the connections bound to a local port, hashed by local
+ * port number.  These spare tcp_active() and tcp_listener() a scan of all
+ * of the connections.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_connhash[CONFIG_NET_TCP_NHASH];
+static FAR struct tcp_conn_s *g_tcp_porthash[CONFIG_NET_TCP_NHASH];
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
@@ -88,6 +97,79 @@ static uint16_t g_last_tcp_port;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_setport()
+ *
+ * Description:
+ *   Set the local port number (in network byte order) of a connection and
+ *   move the connection to the matching chain of the port hash table.  A
+ *   port number of zero removes the connection from the table.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void tcp_setport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+  FAR struct tcp_conn_s **pprev;
+  int ndx;
+
+  if (conn->lport != 0)
+    {
+      pprev = &g_tcp_porthash[TCP_PORTHASH(conn->lport)];
+      while (*pprev != conn)
+        {
+          pprev = &(*pprev)->pnext;
+        }
+
+      *pprev = conn->pnext;
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      ndx                 = TCP_PORTHASH(portno);
+      conn->pnext         = g_tcp_porthash[ndx];
+      g_tcp_porthash[ndx] = conn;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_hashconn() and tcp_unhashconn()
+ *
+ * Description:
+ *   Add a connection entering the active list to the connection hash
+ *   table, or remove it.  The port numbers of the connection are not
+ *   changed while it is in the table.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void tcp_hashconn(FAR struct tcp_conn_s *conn)
+{
+  int ndx = TCP_PORTHASH(conn->lport ^ conn->rport);
+
+  conn->hnext         = g_tcp_connhash[ndx];
+  g_tcp_connhash[ndx] = conn;
+}
+
+static void tcp_unhashconn(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **pprev;
+
+  pprev = &g_tcp_connhash[TCP_PORTHASH(conn->lport ^ conn->rport)];
+  while (*pprev != conn)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev = conn->hnext;
+}
+
 /****************************************************************************
  * Name: tcp_selectport()
  *
@@ -351,8 +433,13 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_unhashconn(conn);
     }
 
+  /* Release its local port */
+
+  tcp_setport(conn, 0);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -412,9 +499,14 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
 FAR struct tcp_conn_s *tcp_active(struct tcp_iphdr_s *buf)
 {
-  FAR struct tcp_conn_s *conn = (struct tcp_conn_s *)g_active_tcp_connections.head;
+  FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr = net_ip4addr_conv32(buf->srcipaddr);
 
+  /* Only the connections with the same hash of the port numbers need to
+   * be examined.
+   */
+
+  conn = g_tcp_connhash[TCP_PORTHASH(buf->destport ^ buf->srcport)];
   while (conn)
     {
       /* Find an open connection matching the tcp input */
@@ -430,9 +522,9 @@ FAR struct tcp_conn_s *tcp_active(struct tcp_iphdr_s *buf)
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct tcp_conn_s *)conn->node.flink;
+      conn = conn->hnext;
     }
 
   return conn;
@@ -477,13 +569,14 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
 FAR struct tcp_conn_s *tcp_listener(uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
-  int i;
 
-  /* Check if this port number is in use by any active UIP TCP connection */
+  /* Check if this port number is in use by any active UIP TCP connection.
+   * All of the connections bound to a local port are in the port hash
+   * table.
+   */
 
-  for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+  for (conn = g_tcp_porthash[TCP_PORTHASH(portno)]; conn; conn = conn->pnext)
     {
-      conn = &g_tcp_connections[i];
       if (conn->tcpstateflags != TCP_CLOSED && conn->lport == portno)
         {
           /* The port number is in use, return the connection */
@@ -520,7 +613,6 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct tcp_iphdr_s *buf)
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = buf->destport;
       conn->rport         = buf->srcport;
       conn->mss           = TCP_INITIAL_MSS;
       net_ipaddr_copy(conn->ripaddr, net_ip4addr_conv32(buf->srcipaddr));
@@ -551,11 +643,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct tcp_iphdr_s *buf)
       sq_init(&conn->unacked_q);
 #endif
 
-      /* And, finally, put the connection structure into the active list.
-       * Interrupts should already be disabled in this context.
+      /* And, finally, bind the connection structure to the local port and
+       * put it into the active list.  Interrupts should already be disabled
+       * in this context.
        */
 
+      tcp_setport(conn, buf->destport);
       dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_hashconn(conn);
     }
 
   return conn;
@@ -591,10 +686,9 @@ int tcp_bind(FAR struct tcp_conn_s *conn,
 
   flags = net_lock();
   port = tcp_selectport(ntohs(addr->sin_port));
-  net_unlock(flags);
-
   if (port < 0)
     {
+      net_unlock(flags);
       return port;
     }
 
@@ -603,7 +697,8 @@ int tcp_bind(FAR struct tcp_conn_s *conn,
    * interface is supported, the IP address is not of importance.
    */
 
-  conn->lport = addr->sin_port;
+  tcp_setport(conn, addr->sin_port);
+  net_unlock(flags);
 
 #if 0 /* Not used */
 #ifdef CONFIG_NET_IPv6
@@ -663,13 +758,15 @@ int tcp_connect(FAR struct tcp_conn_s *conn,
 
   flags = net_lock();
   port = tcp_selectport(ntohs(conn->lport));
-  net_unlock(flags);
-
   if (port < 0)
     {
+      net_unlock(flags);
       return port;
     }
 
+  tcp_setport(conn, htons((uint16_t)port));
+  net_unlock(flags);
+
   /* Initialize and return the connection structure, bind it to the port number */
 
   conn->tcpstateflags = TCP_SYN_SENT;
@@ -682,7 +779,6 @@ int tcp_connect(FAR struct tcp_conn_s *conn,
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -718,6 +814,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn,
 
   flags = net_lock();
   dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_hashconn(conn);
   net_unlock(flags);
 
   return OK;
@@ -58,9 +58,13 @@
  * Private Data
  ****************************************************************************/
 
-/* The tcp_listenports list all currently listening ports. */
+/* The tcp_listenports hash table lists all currently listening ports.
+ * The listeners are chained through their hnext field, which is unused
+ * while they are not in the active list.
+ */
 
-static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_TCP_NHASH];
+static uint16_t tcp_nlisteners;
 
 /****************************************************************************
  * Private Functions
@@ -79,18 +83,15 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
 FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 {
-  int ndx;
+  FAR struct tcp_conn_s *conn;
 
-  /* Examine each connection structure in each slot of the listener list */
+  /* Examine each connection structure in the chain of this port */
 
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (conn = tcp_listenports[TCP_PORTHASH(portno)]; conn; conn = conn->hnext)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
+      /* Does the connection have the same local port number? */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-      if (conn && conn->lport == portno)
+      if (conn->lport == portno)
         {
           /* Yes.. we found a listener on this port */
 
@@ -122,10 +123,12 @@ FAR struct tcp_conn_s *tcp_findlistener(uint16_t portno)
 void tcp_listen_initialize(void)
 {
   int ndx;
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (ndx = 0; ndx < CONFIG_NET_TCP_NHASH; ndx++)
     {
       tcp_listenports[ndx] = NULL;
     }
+
+  tcp_nlisteners = 0;
 }
 
 /****************************************************************************
@@ -141,16 +144,18 @@ void tcp_listen_initialize(void)
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s **pprev;
   net_lock_t flags;
-  int ndx;
   int ret = -EINVAL;
 
   flags = net_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+  for (pprev = &tcp_listenports[TCP_PORTHASH(conn->lport)]; *pprev;
+       pprev = &(*pprev)->hnext)
     {
-      if (tcp_listenports[ndx] == conn)
+      if (*pprev == conn)
         {
-          tcp_listenports[ndx] = NULL;
+          *pprev = conn->hnext;
+          tcp_nlisteners--;
           ret = OK;
           break;
         }
@@ -191,29 +196,23 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -EADDRINUSE;
     }
+  else if (tcp_nlisteners >= CONFIG_NET_MAX_LISTENPORTS)
+    {
+      /* There are already as many listeners as allowed */
+
+      ret = -ENOBUFS;
+    }
   else
     {
       /* Otherwise, save a reference to the connection structure in the
        * "listener" list.
        */
 
-      ret = -ENOBUFS; /* Assume failure */
-
-      /* Search all slots until an available slot is found */
-
-      for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-        {
-          /* Is the next slot available? */
-
-          if (!tcp_listenports[ndx])
-            {
-              /* Yes.. we found it */
-
-              tcp_listenports[ndx] = conn;
-              ret = OK;
-              break;
-            }
-        }
+      ndx                  = TCP_PORTHASH(conn->lport);
+      conn->hnext          = tcp_listenports[ndx];
+      tcp_listenports[ndx] = conn;
+      tcp_nlisteners++;
+      ret                  = OK;
     }
 
   net_unlock(flags);
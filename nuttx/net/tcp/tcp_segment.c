@@ -0,0 +1,178 @@
+/****************************************************************************
+ * net/tcp/tcp_segment.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_LARGESEND)
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ETHBUF ((struct eth_hdr_s *)&dev->d_buf[0])
+#define TCPBUF ((struct tcp_iphdr_s *)&dev->d_buf[NET_LL_HDRLEN])
+
+/* Large sends carry no TCP options */
+
+#define SEGMENT_HDRLEN (NET_LL_HDRLEN + IPTCP_HDRLEN)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_segment
+ *
+ * Description:
+ *   Cut the TCP large send in d_buf into segments of d_segmss bytes of
+ *   data, and call the driver callback with each of them in d_buf and
+ *   d_len.  Any other frame is passed to the callback as it is.
+ *
+ * Parameters:
+ *   dev      - The device driver structure holding the frame
+ *   callback - The driver function that sends a frame
+ *
+ * Return:
+ *   The non-zero value returned by the callback if it stopped the
+ *   segmentation, zero otherwise.
+ *
+ * Assumptions:
+ *   Called from the driver with interrupts disabled.
+ *
+ ****************************************************************************/
+
+int tcp_segment(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+{
+  FAR struct tcp_iphdr_s *pbuf = TCPBUF;
+  FAR uint8_t *frame = dev->d_buf;
+  uint8_t hdr[SEGMENT_HDRLEN];
+  uint16_t framelen = dev->d_len;
+  uint16_t mss = dev->d_segmss;
+  uint16_t datalen;
+  uint16_t offset;
+  uint16_t seglen;
+  uint32_t seqno;
+  uint8_t flags;
+  int ret = 0;
+
+  /* Frames other than large TCP sends go out as they are */
+
+  if (mss == 0 || framelen <= SEGMENT_HDRLEN + mss ||
+#ifdef CONFIG_NET_ETHERNET
+      ETHBUF->type != HTONS(ETHTYPE_IP) ||
+#endif
+      pbuf->proto != IP_PROTO_TCP)
+    {
+      return callback(dev);
+    }
+
+  /* Keep the headers of the large send as the template of those of the
+   * segments:  they are overwritten from the second segment on.
+   */
+
+  memcpy(hdr, frame, SEGMENT_HDRLEN);
+  seqno   = tcp_getsequence(pbuf->seqno);
+  flags   = pbuf->flags;
+  datalen = framelen - SEGMENT_HDRLEN;
+
+  for (offset = 0; offset < datalen && ret == 0; offset += seglen)
+    {
+      seglen = datalen - offset;
+      if (seglen > mss)
+        {
+          seglen = mss;
+        }
+
+      /* The segment starts its headers' length before its data */
+
+      dev->d_buf = frame + offset;
+      dev->d_len = SEGMENT_HDRLEN + seglen;
+      pbuf       = TCPBUF;
+
+      if (offset > 0)
+        {
+          memcpy(dev->d_buf, hdr, SEGMENT_HDRLEN);
+          ++g_ipid;
+          pbuf->ipid[0] = g_ipid >> 8;
+          pbuf->ipid[1] = g_ipid & 0xff;
+
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.sent++;
+          g_netstats.ip.sent++;
+#endif
+        }
+
+      /* Only the last segment is pushed */
+
+      pbuf->flags = offset + seglen < datalen ? flags & ~TCP_PSH : flags;
+      tcp_setsequence(pbuf->seqno, seqno + offset);
+
+      pbuf->len[0] = (IPTCP_HDRLEN + seglen) >> 8;
+      pbuf->len[1] = (IPTCP_HDRLEN + seglen) & 0xff;
+
+      pbuf->tcpchksum = 0;
+      pbuf->tcpchksum = ~(tcp_chksum(dev));
+      pbuf->ipchksum  = 0;
+      pbuf->ipchksum  = ~(ip_chksum(dev));
+
+      ret = callback(dev);
+    }
+
+  nllvdbg("%u bytes in segments of %u\n", datalen, mss);
+
+  dev->d_buf = frame;
+  dev->d_len = 0;
+  return ret;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_LARGESEND */
@@ -118,10 +118,17 @@ static void tcp_sendcomplete(FAR struct net_driver_s *dev)
 
   pbuf->urgp[0]     = pbuf->urgp[1] = 0;
 
-  /* Calculate TCP checksum. */
+  /* Calculate TCP checksum.  A large send is only a template for the
+   * headers of its segments, which get their own checksums.
+   */
 
   pbuf->tcpchksum   = 0;
-  pbuf->tcpchksum   = ~(tcp_chksum(dev));
+#ifdef CONFIG_NET_TCP_LARGESEND
+  if (dev->d_segmss == 0)
+#endif
+    {
+      pbuf->tcpchksum = ~(tcp_chksum(dev));
+    }
 
 #ifdef CONFIG_NET_IPv6
 
@@ -142,7 +149,12 @@ static void tcp_sendcomplete(FAR struct net_driver_s *dev)
   /* Calculate IP checksum. */
 
   pbuf->ipchksum    = 0;
-  pbuf->ipchksum    = ~(ip_chksum(dev));
+#ifdef CONFIG_NET_TCP_LARGESEND
+  if (dev->d_segmss == 0)
+#endif
+    {
+      pbuf->ipchksum = ~(ip_chksum(dev));
+    }
 
 #endif /* CONFIG_NET_IPv6 */
 
@@ -205,6 +217,15 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       pbuf->wnd[1] = ((CONFIG_NET_RECEIVE_WINDOW) & 0xff);
     }
 
+#ifdef CONFIG_NET_TCP_LARGESEND
+  /* Tell the driver to cut the frame into segments if it carries more than
+   * one MSS of data.
+   */
+
+  dev->d_segmss = dev->d_len - IPTCP_HDRLEN > tcp_mss(conn) ?
+                  tcp_mss(conn) : 0;
+#endif
+
   /* Finish the IP portion of the message, calculate checksums and send
    * the message.
    */
@@ -277,6 +298,9 @@ void tcp_reset(FAR struct net_driver_s *dev)
   pbuf->flags     = TCP_RST | TCP_ACK;
   dev->d_len      = IPTCP_HDRLEN;
   pbuf->tcpoffset = 5 << 4;
+#ifdef CONFIG_NET_TCP_LARGESEND
+  dev->d_segmss   = 0;
+#endif
 
   /* Flip the seqno and ackno fields in the TCP header. */
 
@@ -552,6 +552,7 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
 #endif
         {
           FAR struct tcp_wrbuffer_s *wrb;
+          size_t maxlen;
           size_t sndlen;
 
           /* Peek at the head of the write queue (but don't remove anything
@@ -568,10 +569,24 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
            * window size.
            */
 
+          maxlen = tcp_mss(conn);
+
+#ifdef CONFIG_NET_TCP_LARGESEND
+          /* If the driver cuts large sends into segments, give it as much
+           * as it takes:  the write buffer is walked and the headers are
+           * set up once for all of these segments.
+           */
+
+          if (dev->d_largesend > maxlen)
+            {
+              maxlen = dev->d_largesend;
+            }
+#endif
+
           sndlen = WRB_PKTLEN(wrb) - WRB_SENT(wrb);
-          if (sndlen > tcp_mss(conn))
+          if (sndlen > maxlen)
             {
-              sndlen = tcp_mss(conn);
+              sndlen = maxlen;
             }
 
           if (sndlen > conn->winsize)
@@ -66,6 +66,7 @@ struct devif_callback_s;  /* Forward reference */
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+  FAR struct udp_conn_s *pnext; /* Next in the local port hash chain */
   net_ipaddr_t ripaddr;   /* The IP address of the remote peer */
   uint16_t lport;         /* The local port number in network byte order */
   uint16_t rport;         /* The remote port number in network byte order */
@@ -61,6 +61,14 @@
 #include "devif/devif.h"
 #include "udp/udp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Hash of a port number (in either byte order) into the port hash table */
+
+#define UDP_PORTHASH(p)  ((((p) >> 8) ^ (p)) % CONFIG_NET_UDP_NHASH)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -78,6 +86,13 @@ static sem_t g_free_sem;
 
 static dq_queue_t g_active_udp_connections;
 
+/* The connections bound to a local port, hashed by local port number.
+ * This spares udp_active() and udp_find_conn() a scan of all of the
+ * connections.
+ */
+
+static FAR struct udp_conn_s *g_udp_porthash[CONFIG_NET_UDP_NHASH];
+
 /* Last port used by a UDP connection connection. */
 
 static uint16_t g_last_udp_port;
@@ -110,6 +125,45 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) sem_post(sem)
 
+/****************************************************************************
+ * Name: udp_setport()
+ *
+ * Description:
+ *   Set the local port number (in network byte order) of a connection and
+ *   move the connection to the matching chain of the port hash table.  A
+ *   port number of zero removes the connection from the table.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR struct udp_conn_s **pprev;
+  int ndx;
+
+  if (conn->lport != 0)
+    {
+      pprev = &g_udp_porthash[UDP_PORTHASH(conn->lport)];
+      while (*pprev != conn)
+        {
+          pprev = &(*pprev)->pnext;
+        }
+
+      *pprev = conn->pnext;
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      ndx                 = UDP_PORTHASH(portno);
+      conn->pnext         = g_udp_porthash[ndx];
+      g_udp_porthash[ndx] = conn;
+    }
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -121,15 +175,17 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
 {
-  int i;
+  FAR struct udp_conn_s *conn;
 
-  /* Now search each connection structure.*/
+  /* Now search each connection structure bound to a port with the same
+   * hash.
+   */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+  for (conn = g_udp_porthash[UDP_PORTHASH(portno)]; conn; conn = conn->pnext)
     {
-      if (g_udp_connections[ i ].lport == portno)
+      if (conn->lport == portno)
         {
-          return &g_udp_connections[ i ];
+          return conn;
         }
     }
 
@@ -271,6 +327,8 @@ FAR struct udp_conn_s *udp_alloc(void)
 
 void udp_free(FAR struct udp_conn_s *conn)
 {
+  net_lock_t flags;
+
   /* The free list is only accessed from user, non-interrupt level and
    * is protected by a semaphore (that behaves like a mutex).
    */
@@ -278,7 +336,12 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+
+  /* The port hash table is accessed from interrupt level as well */
+
+  flags = net_lock();
+  udp_setport(conn, 0);
+  net_unlock(flags);
 
   /* Remove the connection from the active list */
 
@@ -304,21 +367,20 @@ void udp_free(FAR struct udp_conn_s *conn)
 
 FAR struct udp_conn_s *udp_active(FAR struct udp_iphdr_s *buf)
 {
-  FAR struct udp_conn_s *conn =
-    (FAR struct udp_conn_s *)g_active_udp_connections.head;
+  FAR struct udp_conn_s *conn = g_udp_porthash[UDP_PORTHASH(buf->destport)];
 
   while (conn)
     {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, the local port number is checked against the
-       * destination port number in the received packet. If the two port
-       * numbers match, the remote port number is checked if the
-       * connection is bound to a remote port. Finally, if the
-       * connection is bound to a remote IP address, the source IP
-       * address of the packet is checked.
+      /* Only the connections bound to a local port are in the port hash
+       * table. The local port number is checked against the destination
+       * port number in the received packet. If the two port numbers
+       * match, the remote port number is checked if the connection is
+       * bound to a remote port. Finally, if the connection is bound to a
+       * remote IP address, the source IP address of the packet is
+       * checked.
        */
 
-      if (conn->lport != 0 && buf->destport == conn->lport &&
+      if (buf->destport == conn->lport &&
           (conn->rport == 0 || buf->srcport == conn->rport) &&
             (net_ipaddr_cmp(conn->ripaddr, g_allzeroaddr) ||
              net_ipaddr_cmp(conn->ripaddr, g_alloneaddr) ||
@@ -329,9 +391,9 @@ FAR struct udp_conn_s *udp_active(FAR struct udp_iphdr_s *buf)
           break;
         }
 
-      /* Look at the next active connection */
+      /* Look at the next connection in the hash chain */
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      conn = conn->pnext;
     }
 
   return conn;
@@ -382,34 +444,31 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr_in *addr)
   int ret = -EADDRINUSE;
   net_lock_t flags;
 
+  /* Interrupts must be disabled while access the UDP connection list */
+
+  flags = net_lock();
+
   /* Is the user requesting to bind to any port? */
 
   if (!addr->sin_port)
     {
       /* Yes.. Find an unused local port number */
 
-      conn->lport = htons(udp_select_port());
-      ret         = OK;
+      udp_setport(conn, htons(udp_select_port()));
+      ret = OK;
     }
-  else
-    {
-      /* Interrupts must be disabled while access the UDP connection list */
-
-      flags = net_lock();
 
-      /* Is any other UDP connection bound to this port? */
+  /* Is any other UDP connection bound to this port? */
 
-      if (!udp_find_conn(addr->sin_port))
-        {
-          /* No.. then bind the socket to the port */
-
-          conn->lport = addr->sin_port;
-          ret         = OK;
-        }
+  else if (!udp_find_conn(addr->sin_port))
+    {
+      /* No.. then bind the socket to the port */
 
-      net_unlock(flags);
+      udp_setport(conn, addr->sin_port);
+      ret = OK;
     }
 
+  net_unlock(flags);
   return ret;
 }
 
@@ -443,6 +502,8 @@ int udp_connect(FAR struct udp_conn_s *conn,
                 FAR const struct sockaddr_in *addr)
 #endif
 {
+  net_lock_t flags;
+
   /* Has this address already been bound to a local port (lport)? */
 
   if (!conn->lport)
@@ -451,7 +512,9 @@ int udp_connect(FAR struct udp_conn_s *conn,
        * connection structure.
        */
 
-      conn->lport = htons(udp_select_port());
+      flags = net_lock();
+      udp_setport(conn, htons(udp_select_port()));
+      net_unlock(flags);
     }
 
   /* Is there a remote port (rport) */
@@ -41,8 +41,10 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -57,6 +59,19 @@
 #define BUF ((struct net_iphdr_s *)&dev->d_buf[NET_LL_HDRLEN])
 #define ICMPBUF ((struct icmp_iphdr_s *)&dev->d_buf[NET_LL_HDRLEN])
 
+/* Swap the bytes of a 16-bit one's complement sum, and convert a sum of
+ * words in host byte order to the sum of the same words in network byte
+ * order (RFC1071, byte order independence).
+ */
+
+#define CHKSUM_SWAP(s)  ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_NTOHS(s) (s)
+#else
+#  define CHKSUM_NTOHS(s) CHKSUM_SWAP(s)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -65,47 +80,115 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 32-bit one's complement sum into 16 bits.
+ *
+ ****************************************************************************/
+
+#if !CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t chksum_fold(uint32_t sum)
+{
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum = (sum >> 16) + (sum & 0xffff);
+  return (uint16_t)sum;
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
+/****************************************************************************
+ * Name: chksum_words
+ *
+ * Description:
+ *   Sum the 16-bit words of a halfword aligned buffer, in host byte order.
+ *   The words are added eight at a time to two 32-bit accumulators, which
+ *   the compiler can keep in registers or vectorize.  The carries are kept
+ *   in the upper halves:  less than 65536 words cannot overflow them.
+ *
+ *   If CONFIG_ARCH_HAVE_CHKSUM is defined, the architecture provides the
+ *   same function as up_chksum().
+ *
+ ****************************************************************************/
+
+#if !CONFIG_NET_ARCH_CHKSUM
+#ifdef CONFIG_ARCH_HAVE_CHKSUM
+#  define chksum_words(d,n) up_chksum(d,n)
+#else
+static uint32_t chksum_words(FAR const uint16_t *data, size_t nwords)
+{
+  uint32_t sum0 = 0;
+  uint32_t sum1 = 0;
+
+  for (; nwords >= 8; nwords -= 8, data += 8)
+    {
+      sum0 += (uint32_t)data[0] + data[2] + data[4] + data[6];
+      sum1 += (uint32_t)data[1] + data[3] + data[5] + data[7];
+    }
+
+  while (nwords-- > 0)
+    {
+      sum0 += *data++;
+    }
+
+  return sum0 + sum1;
+}
+#endif /* CONFIG_ARCH_HAVE_CHKSUM */
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
 /****************************************************************************
  * Name: chksum
+ *
+ * Description:
+ *   Add the Internet checksum of a buffer to sum, in host byte order.
+ *
  ****************************************************************************/
 
 #if !CONFIG_NET_ARCH_CHKSUM
 static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
+  uint32_t acc;
+  uint16_t words;
+  uint16_t first = 0;
+  bool odd;
+
+  if (len == 0)
+    {
+      return sum;
+    }
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* The words are summed from a 16-bit boundary.  If the buffer starts at
+   * an odd address, its first byte is added apart and the bytes of the
+   * other words are swapped, so the sum of these is swapped back.
+   */
 
-  while (dataptr < last_byte)
+  odd = ((uintptr_t)data & 1) != 0;
+  if (odd)
     {
-      /* At least two more bytes */
+      first = *data++;
+      len--;
+    }
 
-      t = (dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  /* CHKSUM_NTOHS() uses its argument twice: sum the words only once */
+
+  words = chksum_fold(chksum_words((FAR const uint16_t *)data, len >> 1));
+  acc   = CHKSUM_NTOHS(words);
 
-      dataptr += 2;
+  if ((len & 1) != 0)
+    {
+      acc += (uint16_t)data[len - 1] << 8;
     }
 
-  if (dataptr == last_byte)
+  if (odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      acc  = chksum_fold(acc);
+      acc  = CHKSUM_SWAP(acc);
+      acc += first << 8;
     }
 
   /* Return sum in host byte order. */
 
-  return sum;
+  return chksum_fold(acc + sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -263,6 +346,38 @@ uint16_t net_chksum(FAR uint16_t *data, uint16_t len)
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_chksum_update
+ *
+ * Description:
+ *   Update an Internet checksum for the change of one 16-bit word of the
+ *   data it covers, without summing the data again (RFC1624).  Header
+ *   rewrites such as the ICMP echo reply use this.
+ *
+ * Input Parameters:
+ *   chksum - The checksum, as stored in the header
+ *   oldval - The previous value of the word, as stored in the header
+ *   newval - The new value of the word, as stored in the header
+ *
+ * Returned Value:
+ *   The updated checksum, to be stored in the header.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_update(uint16_t chksum, uint16_t oldval, uint16_t newval)
+{
+  uint32_t sum;
+
+  /* HC' = ~(~HC + ~m + m').  The one's complement sum does not depend on
+   * the byte order, so the values are used as stored.
+   */
+
+  sum  = (uint32_t)(uint16_t)~chksum + (uint16_t)~oldval + newval;
+  sum  = (sum >> 16) + (sum & 0xffff);
+  sum += sum >> 16;
+  return (uint16_t)~sum;
+}
+
 /****************************************************************************
  * Name: ip_chksum
  *
@@ -135,6 +135,15 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOQUEUE
+/* These are the indexes of the g_readytorun and g_pendingtasks lists.  The
+ * IDLE task is never indexed:  it is always the last TCB of g_readytorun.
+ */
+
+struct prioq_s g_readytorun_prioq;
+struct prioq_s g_pendingtasks_prioq;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
@@ -73,7 +73,7 @@
 
 #include "irq/irq.h"
 
-#if defined(CONFIG_USEC_MEASURE_PERF)
+#if defined(CONFIG_USEC_MEASURE_PERF) || defined(CONFIG_SCHED_SCHEDSTAT)
 #include "sched/sched.h"
 #endif
 
@@ -114,6 +114,15 @@
 void irq_dispatch(int irq, FAR void *context)
 {
   xcpt_t vector;
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  uint32_t start;
+#endif
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  /* Stop charging the running thread */
+
+  start = sched_stat_irqenter();
+#endif
 
 #if defined(CONFIG_USEC_MEASURE_PERF)
   /* stop tracking current tcb and track interrupt timing  */
@@ -144,5 +153,11 @@ void irq_dispatch(int irq, FAR void *context)
   sched_track_irq_stop();
 #endif
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  /* Charge the interrupt, then the thread now running */
+
+  sched_stat_irqleave(irq, start);
+#endif
+
 }
 
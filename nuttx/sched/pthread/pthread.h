@@ -50,10 +50,29 @@
 
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#  include <arch/atomic.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Take a free mutex, or give back a mutex that no thread waits for, with an
+ * atomic update of the count of its semaphore.  This is consistent with
+ * sem_wait() and sem_post(), which update the count with the interrupts
+ * disabled.  Both evaluate to false when the fast path is not configured or
+ * cannot be used, then the semaphore must be waited for or posted.
+ */
+
+#ifdef CONFIG_PTHREAD_MUTEX_FASTPATH
+#  define pthread_mutex_fasttake(m) atomic_cmpxchg16(&(m)->sem.semcount, 1, 0)
+#  define pthread_mutex_fastgive(m) atomic_cmpxchg16(&(m)->sem.semcount, 0, 1)
+#else
+#  define pthread_mutex_fasttake(m) false
+#  define pthread_mutex_fastgive(m) false
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -127,6 +127,19 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
     {
       ret = EINVAL;
     }
+
+  /* Take a free mutex without locking the scheduler.  Only the holder
+   * could have set the pid to its own, a relock always takes the path
+   * below.
+   */
+
+  else if (mutex->pid != mypid && pthread_mutex_fasttake(mutex))
+    {
+      mutex->pid    = mypid;
+#ifdef CONFIG_MUTEX_TYPES
+      mutex->nlocks = 1;
+#endif
+    }
   else
     {
       /* Make sure the semaphore is stable while we make the following
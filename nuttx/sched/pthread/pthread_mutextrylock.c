@@ -106,6 +106,13 @@ int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
     {
       ret = EINVAL;
     }
+
+  /* Take a free mutex without locking the scheduler */
+
+  else if (pthread_mutex_fasttake(mutex))
+    {
+      mutex->pid = (int)getpid();
+    }
   else
     {
       /* Make sure the semaphore is stable while we make the following
@@ -111,10 +111,14 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
   else
     {
       /* Make sure the semaphore is stable while we make the following
-       * checks.  This all needs to be one atomic action.
+       * checks.  This all needs to be one atomic action.  With the fast
+       * path, only the holder changes the state checked here, and the count
+       * of the semaphore is updated atomically.
        */
 
+#ifndef CONFIG_PTHREAD_MUTEX_FASTPATH
       sched_lock();
+#endif
 
       /* Does the calling thread own the semaphore? */
 
@@ -146,15 +150,23 @@ int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
 
       else
         {
-          /* Nullify the pid and lock count then post the semaphore */
+          /* Nullify the pid and lock count then post the semaphore, unless
+           * no thread waits for it and the count can simply be restored.
+           */
 
           mutex->pid    = 0;
 #ifdef CONFIG_MUTEX_TYPES
           mutex->nlocks = 0;
 #endif
-          ret = pthread_givesemaphore((sem_t*)&mutex->sem);
+          if (!pthread_mutex_fastgive(mutex))
+            {
+              ret = pthread_givesemaphore((sem_t*)&mutex->sem);
+            }
         }
+
+#ifndef CONFIG_PTHREAD_MUTEX_FASTPATH
       sched_unlock();
+#endif
     }
 
   sdbg("Returning %d\n", ret);
@@ -136,6 +136,30 @@ struct tasklist_s
   bool prioritized;               /* true if the list is prioritized */
 };
 
+#ifdef CONFIG_SCHED_PRIOQUEUE
+/* This structure indexes a prioritized task list so that a TCB can be
+ * inserted without walking the list:  it records the last TCB of each
+ * priority present in the list, and a bitmap of these priorities.  The
+ * summary has one bit per non-empty word of the bitmap.
+ */
+
+#define PRIOQ_NWORDS ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+struct prioq_s
+{
+  FAR struct tcb_s *last[SCHED_PRIORITY_MAX + 1];
+  uint32_t bitmap[PRIOQ_NWORDS];
+  uint32_t summary;
+};
+
+/* Returns the index of a task list, NULL if the list is not indexed */
+
+#define SCHED_PRIOQ(list) \
+  ((list) == (FAR dq_queue_t *)&g_readytorun ? &g_readytorun_prioq : \
+   (list) == (FAR dq_queue_t *)&g_pendingtasks ? &g_pendingtasks_prioq : \
+   (FAR struct prioq_s *)NULL)
+#endif
+
 /****************************************************************************
  * Global Variables
  ****************************************************************************/
@@ -165,6 +189,13 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_PRIOQUEUE
+/* These are the indexes of the g_readytorun and g_pendingtasks lists */
+
+extern struct prioq_s g_readytorun_prioq;
+extern struct prioq_s g_pendingtasks_prioq;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -255,6 +286,12 @@ extern volatile uint32_t g_cpuload_total;
 bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
+#ifdef CONFIG_SCHED_PRIOQUEUE
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#  define sched_removeprioritized(tcb,list) \
+     dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
 bool sched_mergepending(void);
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
@@ -295,6 +332,16 @@ void sched_track_pre_exit(struct tcb_s* dead_tcb);
 void sched_track_post_exit(struct tcb_s* new_tcb);
 #endif
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+void sched_stat_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+void sched_stat_wakeup(FAR struct tcb_s *tcb);
+uint32_t sched_stat_irqenter(void);
+void sched_stat_irqleave(int irq, uint32_t start);
+#else
+#  define sched_stat_switch(from,to)
+#  define sched_stat_wakeup(tcb)
+#endif
+
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int  sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
@@ -66,6 +66,151 @@
  * Private Function Prototypes
  ************************************************************************/
 
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+#ifdef CONFIG_SCHED_PRIOQUEUE
+/************************************************************************
+ * Name: prioq_ctz
+ *
+ * Description:
+ *   Return the index of the least significant bit set in a non-zero
+ *   value.
+ *
+ ************************************************************************/
+
+#ifdef __GNUC__
+#  define prioq_ctz(value) __builtin_ctz(value)
+#else
+static inline int prioq_ctz(uint32_t value)
+{
+  int bit = 0;
+
+  if ((value & 0x0000ffff) == 0)
+    {
+      value >>= 16;
+      bit    += 16;
+    }
+
+  if ((value & 0x000000ff) == 0)
+    {
+      value >>= 8;
+      bit    += 8;
+    }
+
+  if ((value & 0x0000000f) == 0)
+    {
+      value >>= 4;
+      bit    += 4;
+    }
+
+  if ((value & 0x00000003) == 0)
+    {
+      value >>= 2;
+      bit    += 2;
+    }
+
+  if ((value & 0x00000001) == 0)
+    {
+      bit    += 1;
+    }
+
+  return bit;
+}
+#endif
+
+/************************************************************************
+ * Name: prioq_findprev
+ *
+ * Description:
+ *   Return the TCB after which a TCB of the given priority must be
+ *   inserted in an indexed list:  the last TCB of the lowest priority
+ *   greater than or equal to sched_priority present in the list.  NULL
+ *   is returned if the TCB must be inserted at the head of the list.
+ *
+ ************************************************************************/
+
+static FAR struct tcb_s *prioq_findprev(FAR struct prioq_s *prioq,
+                                        uint8_t sched_priority)
+{
+  unsigned int word = sched_priority >> 5;
+  uint32_t bits;
+  uint32_t words;
+
+  bits = prioq->bitmap[word] & (0xffffffff << (sched_priority & 31));
+  if (bits == 0)
+    {
+      /* Look for the next non-empty word of the bitmap */
+
+      words = prioq->summary & ~((2 << word) - 1);
+      if (words == 0)
+        {
+          return NULL;
+        }
+
+      word = prioq_ctz(words);
+      bits = prioq->bitmap[word];
+    }
+
+  return prioq->last[(word << 5) + prioq_ctz(bits)];
+}
+
+/************************************************************************
+ * Name: prioq_add
+ *
+ * Description:
+ *   Add a TCB to an indexed prioritized list in constant time.
+ *
+ ************************************************************************/
+
+static bool prioq_add(FAR struct prioq_s *prioq, FAR struct tcb_s *tcb,
+                      DSEG dq_queue_t *list)
+{
+  FAR struct tcb_s *prev;
+  FAR struct tcb_s *next;
+  uint8_t sched_priority = tcb->sched_priority;
+  bool ret = false;
+
+  prev = prioq_findprev(prioq, sched_priority);
+  if (prev)
+    {
+      /* The tcb goes just after prev */
+
+      next = prev->flink;
+      prev->flink = tcb;
+    }
+  else
+    {
+      /* Insert at the head of the list */
+
+      next = (FAR struct tcb_s*)list->head;
+      list->head = (FAR dq_entry_t*)tcb;
+      ret = true;
+    }
+
+  tcb->flink = next;
+  tcb->blink = prev;
+
+  if (next)
+    {
+      next->blink = tcb;
+    }
+  else
+    {
+      list->tail = (FAR dq_entry_t*)tcb;
+    }
+
+  /* The tcb is now the last one of its priority */
+
+  prioq->last[sched_priority]         = tcb;
+  prioq->bitmap[sched_priority >> 5] |= (uint32_t)1 << (sched_priority & 31);
+  prioq->summary                     |= (uint32_t)1 << (sched_priority >> 5);
+
+  return ret;
+}
+#endif /* CONFIG_SCHED_PRIOQUEUE */
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -101,11 +246,24 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
   FAR struct tcb_s *prev;
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
+#ifdef CONFIG_SCHED_PRIOQUEUE
+  FAR struct prioq_s *prioq;
+#endif
 
   /* Lets do a sanity check before we get started. */
 
   ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_PRIOQUEUE
+  /* Indexed lists do not need to be searched */
+
+  prioq = SCHED_PRIOQ(list);
+  if (prioq)
+    {
+      return prioq_add(prioq, tcb, list);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in ascending sched_priority order.
    */
@@ -92,6 +92,48 @@
  *
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_PRIOQUEUE
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *pndtcb;
+  FAR struct tcb_s *pndnext;
+  FAR struct tcb_s *rtrtcb;
+  bool ret = false;
+
+  rtrtcb = (FAR struct tcb_s*)g_readytorun.head;
+
+  /* Move every TCB of the g_pendingtasks list to the g_readytorun list.
+   * Both lists are indexed, so there is no list to search.
+   */
+
+  for (pndtcb = (FAR struct tcb_s*)g_pendingtasks.head; pndtcb; pndtcb = pndnext)
+    {
+      pndnext = pndtcb->flink;
+
+      sched_removeprioritized(pndtcb, (FAR dq_queue_t*)&g_pendingtasks);
+      if (sched_addprioritized(pndtcb, (FAR dq_queue_t*)&g_readytorun))
+        {
+          /* pndtcb was inserted at the head of the list.  Inform the
+           * instrumentation layer that we are switching tasks.
+           */
+
+          sched_note_switch(rtrtcb, pndtcb);
+          sched_stat_switch(rtrtcb, pndtcb);
+
+          rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+          pndtcb->task_state = TSTATE_TASK_RUNNING;
+          rtrtcb             = pndtcb;
+          ret                = true;
+        }
+      else
+        {
+          pndtcb->task_state = TSTATE_TASK_READYTORUN;
+        }
+    }
+
+  return ret;
+}
+#else
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *pndtcb;
@@ -136,6 +178,7 @@ bool sched_mergepending(void)
           /* Inform the instrumentation layer that we are switching tasks */
 
           sched_note_switch(rtrtcb, pndtcb);
+          sched_stat_switch(rtrtcb, pndtcb);
 
           /* Then insert at the head of the list */
 
@@ -170,3 +213,4 @@ bool sched_mergepending(void)
 
   return ret;
 }
+#endif /* CONFIG_SCHED_PRIOQUEUE */
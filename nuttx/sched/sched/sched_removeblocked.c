@@ -107,5 +107,9 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+  /* It is ready to run from now on */
+
+  sched_stat_wakeup(btcb);
 }
 
@@ -0,0 +1,109 @@
+/************************************************************************
+ * sched/sched/sched_removeprioritized.c
+ *
+ *   Copyright (C) 2007, 2009 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIOQUEUE
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *  This function removes a TCB from a task list, keeping the index of
+ *  the list up to date if the list is indexed.  Any other list is
+ *  handled as a plain dq_rem().
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove
+ *   list - Points to the list holding tcb
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The priority of the TCB has not been changed since it was added to
+ *   the list.
+ *
+ ************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+  FAR struct prioq_s *prioq = SCHED_PRIOQ(list);
+  FAR struct tcb_s *prev = tcb->blink;
+  uint8_t sched_priority = tcb->sched_priority;
+
+  if (prioq && prioq->last[sched_priority] == tcb)
+    {
+      /* The TCB was the last one of its priority.  The previous TCB now
+       * is, unless there is no other TCB of this priority in the list.
+       */
+
+      if (prev && prev->sched_priority == sched_priority)
+        {
+          prioq->last[sched_priority] = prev;
+        }
+      else
+        {
+          prioq->last[sched_priority] = NULL;
+          prioq->bitmap[sched_priority >> 5] &=
+            ~((uint32_t)1 << (sched_priority & 31));
+
+          if (prioq->bitmap[sched_priority >> 5] == 0)
+            {
+              prioq->summary &= ~((uint32_t)1 << (sched_priority >> 5));
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_PRIOQUEUE */
@@ -109,13 +109,14 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
       /* Inform the instrumentation layer that we are switching tasks */
 
       sched_note_switch(rtcb, ntcb);
+      sched_stat_switch(rtcb, ntcb);
       ntcb->task_state = TSTATE_TASK_RUNNING;
       ret = true;
     }
 
   /* Remove the TCB from the ready-to-run list */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_removeprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -0,0 +1,289 @@
+/****************************************************************************
+ * sched/sched/sched_schedstat.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/hires_tmr.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* Time up to which the running thread, or the interrupt handlers, have
+ * been accounted for.
+ */
+
+static uint32_t g_statstamp;
+
+/* Nesting level of the interrupt handlers.  The running thread is only
+ * charged the time spent outside of them.
+ */
+
+static uint8_t g_irqnesting;
+
+#if NR_IRQS > 0
+static struct irqstat_s g_irqstat[NR_IRQS];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_stat_switch
+ *
+ * Description:
+ *   Account for a context switch, called when the head of the ready-to-run
+ *   list changes.  Whether the switch out was voluntary is only known when
+ *   the thread is switched in again:  it was if the thread was unblocked in
+ *   the meantime, it was preempted otherwise.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stat_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  uint32_t now = hrt_getusec();
+  uint32_t latency;
+
+  /* Within an interrupt handler, the time is charged to the handler and
+   * the thread was charged when the handler was entered.
+   */
+
+  if (g_irqnesting == 0)
+    {
+      from->stat.runtime += now - g_statstamp;
+      g_statstamp = now;
+    }
+
+  from->stat.stamp = now;
+
+  /* The thread switched in was waiting since it was switched out or,
+   * if it blocked, since it was unblocked.
+   */
+
+  latency = now - to->stat.stamp;
+  to->stat.waittime += latency;
+  if (latency > to->stat.maxlatency)
+    {
+      to->stat.maxlatency = latency;
+    }
+
+  if (to->stat.nswitches++ > 0)
+    {
+      if (to->stat.woken)
+        {
+          to->stat.nvcsw++;
+        }
+      else
+        {
+          to->stat.nivcsw++;
+        }
+    }
+
+  to->stat.woken = false;
+}
+
+/****************************************************************************
+ * Name: sched_stat_wakeup
+ *
+ * Description:
+ *   Account for a thread unblocked, and ready to run from now on.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stat_wakeup(FAR struct tcb_s *tcb)
+{
+  tcb->stat.nwakeups++;
+  tcb->stat.stamp = hrt_getusec();
+  tcb->stat.woken = true;
+}
+
+/****************************************************************************
+ * Name: sched_stat_irqenter
+ *
+ * Description:
+ *   Account for the time spent by the interrupted thread, on entry to an
+ *   interrupt handler.  Returns the time of entry, to be passed back to
+ *   sched_stat_irqleave().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+uint32_t sched_stat_irqenter(void)
+{
+  FAR struct tcb_s *rtcb = (FAR struct tcb_s *)g_readytorun.head;
+  uint32_t now = hrt_getusec();
+
+  if (g_irqnesting++ == 0)
+    {
+      rtcb->stat.runtime += now - g_statstamp;
+      g_statstamp = now;
+    }
+
+  return now;
+}
+
+/****************************************************************************
+ * Name: sched_stat_irqleave
+ *
+ * Description:
+ *   Account for an interrupt handled since 'start', on exit from its
+ *   handler.  The thread running from now on may not be the one that was
+ *   interrupted.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void sched_stat_irqleave(int irq, uint32_t start)
+{
+  uint32_t now = hrt_getusec();
+
+#if NR_IRQS > 0
+  if ((unsigned)irq < NR_IRQS)
+    {
+      g_irqstat[irq].time += now - start;
+      g_irqstat[irq].count++;
+    }
+#endif
+
+  if (--g_irqnesting == 0)
+    {
+      g_statstamp = now;
+    }
+}
+
+/****************************************************************************
+ * Function:  sched_schedstat
+ *
+ * Description:
+ *   Return the scheduler statistics of the selected PID.
+ *
+ * Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE thread.
+ *   stat - The location to return the statistics
+ *
+ * Return Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int sched_schedstat(pid_t pid, FAR struct schedstat_s *stat)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int ret = -ESRCH;
+
+  DEBUGASSERT(stat);
+
+  flags = irqsave();
+  tcb = sched_gettcb(pid);
+  if (tcb)
+    {
+      memcpy(stat, &tcb->stat, sizeof(struct schedstat_s));
+
+      /* Add the time the running thread was not yet charged */
+
+      if (tcb == (FAR struct tcb_s *)g_readytorun.head && g_irqnesting == 0)
+        {
+          stat->runtime += hrt_getusec() - g_statstamp;
+        }
+
+      ret = OK;
+    }
+
+  irqrestore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Function:  sched_irqstat
+ *
+ * Description:
+ *   Return the statistics of an interrupt.
+ *
+ * Parameters:
+ *   irq - The interrupt of interest.
+ *   stat - The location to return the statistics
+ *
+ * Return Value:
+ *   OK (0) on success; -EINVAL if there is no such interrupt.
+ *
+ ****************************************************************************/
+
+int sched_irqstat(int irq, FAR struct irqstat_s *stat)
+{
+#if NR_IRQS > 0
+  irqstate_t flags;
+
+  DEBUGASSERT(stat);
+
+  if ((unsigned)irq < NR_IRQS)
+    {
+      flags = irqsave();
+      memcpy(stat, &g_irqstat[irq], sizeof(struct irqstat_s));
+      irqrestore(flags);
+      return OK;
+    }
+#endif
+
+  return -EINVAL;
+}
+
+#endif /* CONFIG_SCHED_SCHEDSTAT */
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <semaphore.h>
 #include <sched.h>
 #include <assert.h>
@@ -99,25 +100,26 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
    * used to implement mutexes.
    */
 
+  if (!sem->holder.htcb)
+    {
+      pholder          = &sem->holder;
+      pholder->counts  = 0;
+    }
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder)
+  else if (g_freeholders)
     {
-      /* Remove the holder from the free list an put it into the semaphore's holder list */
+      /* Remove the holder from the free list and link it after the built-in
+       * holder, which always heads the semaphore's holder list.
+       */
 
-      g_freeholders    = pholder->flink;
-      pholder->flink   = sem->hhead;
-      sem->hhead       = pholder;
+      pholder           = g_freeholders;
+      g_freeholders     = pholder->flink;
+      pholder->flink    = sem->holder.flink;
+      sem->holder.flink = pholder;
 
       /* Make sure the initial count is zero */
 
-      pholder->counts  = 0;
-    }
-#else
-  if (!sem->holder.htcb)
-    {
-      pholder          = &sem->holder;
-      pholder->counts  = 0;
+      pholder->counts   = 0;
     }
 #endif
   else
@@ -141,7 +143,7 @@ static FAR struct semholder_s *sem_findholder(sem_t *sem,
   /* Try to find the holder in the list of holders associated with this semaphore */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  for (pholder = sem->hhead; pholder; pholder = pholder->flink)
+  for (pholder = &sem->holder; pholder; pholder = pholder->flink)
 #else
   pholder = &sem->holder;
 #endif
@@ -175,6 +177,21 @@ sem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
   return pholder;
 }
 
+/****************************************************************************
+ * Name: sem_hasmoreholders
+ ****************************************************************************/
+
+static inline bool sem_hasmoreholders(FAR sem_t *sem)
+{
+  /* Are there holders other than the built-in one? */
+
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  return sem->holder.flink != NULL;
+#else
+  return false;
+#endif
+}
+
 /****************************************************************************
  * Name: sem_freeholder
  ****************************************************************************/
@@ -192,9 +209,16 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
   pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Search the list for the matching holder */
+  /* The built-in holder stays at the head of the list.  Otherwise, search
+   * the list for the matching holder.
+   */
+
+  if (pholder == &sem->holder)
+    {
+      return;
+    }
 
-  for (prev = NULL, curr = sem->hhead;
+  for (prev = &sem->holder, curr = prev->flink;
        curr && curr != pholder;
        prev = curr, curr = curr->flink);
 
@@ -202,14 +226,7 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
     {
       /* Remove the holder from the list */
 
-      if (prev)
-        {
-          prev->flink = pholder->flink;
-        }
-      else
-        {
-          sem->hhead = pholder->flink;
-        }
+      prev->flink = pholder->flink;
 
       /* And put it in the free list */
 
@@ -232,7 +249,7 @@ static int sem_foreachholder(FAR sem_t *sem, holderhandler_t handler, FAR void *
   int ret = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
+  for (pholder = &sem->holder; pholder && ret == 0; pholder = next)
 #else
   pholder = &sem->holder;
 #endif
@@ -687,6 +704,22 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb, FAR sem_t *s
   FAR struct tcb_s *rtcb = (FAR struct tcb_s*)g_readytorun.head;
   FAR struct semholder_s *pholder;
 
+  /* A mutex released without contention:  no thread waits for it, so no
+   * priority was boosted, and the running task is its only holder.  Just
+   * release the built-in holder when no more counts are held.
+   */
+
+  if (!stcb && sem->holder.htcb == rtcb && !sem_hasmoreholders(sem))
+    {
+      if (sem->holder.counts <= 0)
+        {
+          sem->holder.htcb   = NULL;
+          sem->holder.counts = 0;
+        }
+
+      return;
+    }
+
   /* Perfom the following actions only if a new thread was given a count.
    * The thread that received the count should be the highest priority
    * of all threads waiting for a count from the semaphore.  So in that
@@ -810,7 +843,7 @@ void sem_destroyholder(FAR sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead)
+  if (sem->holder.htcb || sem->holder.flink)
     {
       sdbg("Semaphore destroyed with holders\n");
       (void)sem_foreachholder(sem, sem_recoverholders, NULL);
@@ -844,11 +877,22 @@ void sem_destroyholder(FAR sem_t *sem)
 void sem_addholder(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = (FAR struct tcb_s*)g_readytorun.head;
-  FAR struct semholder_s *pholder;
+  FAR struct semholder_s *pholder = &sem->holder;
+
+  /* A mutex has one holder at a time:  take the built-in holder if there
+   * are no other holders, keep it if this thread already has it, and only
+   * search or allocate a container for this new holder otherwise.
+   */
 
-  /* Find or allocate a container for this new holder */
+  if (!pholder->htcb && !sem_hasmoreholders(sem))
+    {
+      pholder->counts = 0;
+    }
+  else if (pholder->htcb != rtcb)
+    {
+      pholder = sem_findorallocateholder(sem, rtcb);
+    }
 
-  pholder = sem_findorallocateholder(sem, rtcb);
   if (pholder)
     {
       /* Then set the holder and increment the number of counts held by this holder */
@@ -908,9 +952,14 @@ void sem_releaseholder(FAR sem_t *sem)
   FAR struct tcb_s *rtcb = (FAR struct tcb_s*)g_readytorun.head;
   FAR struct semholder_s *pholder;
 
-  /* Find the container for this holder */
+  /* Find the container for this holder, the built-in one first */
+
+  pholder = &sem->holder;
+  if (pholder->htcb != rtcb)
+    {
+      pholder = sem_findholder(sem, rtcb);
+    }
 
-  pholder = sem_findholder(sem, rtcb);
   if (pholder && pholder->counts > 0)
     {
       /* Decrement the counts on this holder -- the holder will be freed
@@ -160,7 +160,7 @@ int task_restart(pid_t pid)
        */
 
       state = irqsave();
-      dq_rem((FAR dq_entry_t*)tcb,
+      sched_removeprioritized((FAR struct tcb_s *)tcb,
              (dq_queue_t*)g_tasklisttable[tcb->cmn.task_state].list);
       tcb->cmn.task_state = TSTATE_TASK_INVALID;
       irqrestore(state);
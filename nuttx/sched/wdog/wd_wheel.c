@@ -0,0 +1,382 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2016 Motorola Mobility, LLC. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has WHEEL_LEVELS levels of WHEEL_SIZE slots.  A level 0 slot
+ * holds the watchdogs expiring on a given tick, a level n slot the ones
+ * expiring within a given window of WHEEL_SIZE^n ticks.  When the time
+ * enters that window, the slot is cascaded to the lower levels.
+ *
+ * Each level has a 32-bit bitmap of its non-empty slots, which is what
+ * makes finding the next event cheap.
+ */
+
+#define WHEEL_BITS       5
+#define WHEEL_SIZE       (1 << WHEEL_BITS)
+#define WHEEL_MASK       (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS     5
+
+#define WHEEL_SHIFT(l)   ((l) * WHEEL_BITS)
+#define WHEEL_SPAN(l)    ((uint32_t)1 << WHEEL_SHIFT((l) + 1))
+#define WHEEL_RANGE      WHEEL_SPAN(WHEEL_LEVELS - 1)
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* Each slot is a list linked through the next field of the watchdogs and
+ * terminated by NULL.  The prev field of the first watchdog points to the
+ * last one, so that watchdogs are appended in constant time.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS][WHEEL_SIZE];
+static uint32_t g_wdbitmap[WHEEL_LEVELS];
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* This is the time of the wheel, in ticks.  Watchdogs due at this time have
+ * already been processed.
+ */
+
+uint32_t g_wdtick;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_ctz
+ *
+ * Description:
+ *   Return the index of the least significant bit set in a non-zero value.
+ *
+ ****************************************************************************/
+
+#ifdef __GNUC__
+#  define wd_wheel_ctz(value) __builtin_ctz(value)
+#else
+static inline unsigned int wd_wheel_ctz(uint32_t value)
+{
+  unsigned int bit = 0;
+
+  while ((value & 1) == 0)
+    {
+      value >>= 1;
+      bit++;
+    }
+
+  return bit;
+}
+#endif
+
+/****************************************************************************
+ * Name: wd_wheel_distance
+ *
+ * Description:
+ *   Return the distance, between 1 and WHEEL_SIZE, from a slot to the next
+ *   non-empty slot of a level, wrapping around.  A slot is its own next slot
+ *   at a distance of WHEEL_SIZE.
+ *
+ ****************************************************************************/
+
+static inline unsigned int wd_wheel_distance(uint32_t bitmap,
+                                             unsigned int index)
+{
+  unsigned int shift = (index + 1) & WHEEL_MASK;
+
+  if (shift != 0)
+    {
+      bitmap = (bitmap >> shift) | (bitmap << (WHEEL_SIZE - shift));
+    }
+
+  return wd_wheel_ctz(bitmap) + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move all of the watchdogs of a slot to the lower levels of the wheel.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, unsigned int index)
+{
+  FAR struct wdog_s *wdog = g_wdwheel[level][index];
+  FAR struct wdog_s *next;
+
+  g_wdwheel[level][index] = NULL;
+  g_wdbitmap[level] &= ~((uint32_t)1 << index);
+
+  for (; wdog; wdog = next)
+    {
+      next = wdog->next;
+      wd_wheel_add(wdog);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the wheel, according to its expiry field.  Watchdogs
+ *   further than the range of the wheel are parked in its last level and
+ *   moved down when it is cascaded.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s *head;
+  uint32_t expiry = wdog->expiry;
+  uint32_t delta = expiry - g_wdtick;
+  unsigned int index;
+  int level;
+
+  if (delta >= WHEEL_RANGE)
+    {
+      delta  = WHEEL_RANGE - 1;
+      expiry = g_wdtick + delta;
+    }
+
+  for (level = 0; delta >= WHEEL_SPAN(level); level++);
+
+  index = (expiry >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+  head  = g_wdwheel[level][index];
+
+  wdog->next = NULL;
+  if (head)
+    {
+      wdog->prev       = head->prev;
+      head->prev->next = wdog;
+      head->prev       = wdog;
+    }
+  else
+    {
+      wdog->prev = wdog;
+      g_wdwheel[level][index] = wdog;
+      g_wdbitmap[level] |= (uint32_t)1 << index;
+    }
+
+  wdog->slot = level * WHEEL_SIZE + index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the wheel.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  int level = wdog->slot / WHEEL_SIZE;
+  unsigned int index = wdog->slot & WHEEL_MASK;
+  FAR struct wdog_s *head = g_wdwheel[level][index];
+
+  if (wdog == head)
+    {
+      head = wdog->next;
+      g_wdwheel[level][index] = head;
+      if (head)
+        {
+          head->prev = wdog->prev;
+        }
+      else
+        {
+          g_wdbitmap[level] &= ~((uint32_t)1 << index);
+        }
+    }
+  else
+    {
+      wdog->prev->next = wdog->next;
+      if (wdog->next)
+        {
+          wdog->next->prev = wdog->prev;
+        }
+      else
+        {
+          head->prev = wdog->prev;
+        }
+    }
+
+  wdog->next = NULL;
+  wdog->prev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Advance the wheel by one tick, cascading the slots entering their
+ *   window.  The watchdogs due on the new tick are then returned by
+ *   wd_wheel_expired().
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_tick(void)
+{
+  int level;
+
+  g_wdtick++;
+
+  for (level = 1; level < WHEEL_LEVELS; level++)
+    {
+      if ((g_wdtick & (((uint32_t)1 << WHEEL_SHIFT(level)) - 1)) != 0)
+        {
+          break;
+        }
+
+      wd_wheel_cascade(level,
+                       (g_wdtick >> WHEEL_SHIFT(level)) & WHEEL_MASK);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return the next watchdog due on the current tick, NULL if
+ *   there are none left.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog = g_wdwheel[0][g_wdtick & WHEEL_MASK];
+
+  if (wdog)
+    {
+      wd_wheel_remove(wdog);
+    }
+
+  return wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next event of the wheel:  either
+ *   watchdogs becoming due or a non-empty slot being cascaded.  Zero is
+ *   returned if the wheel is empty.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_next(void)
+{
+  unsigned int next = 0;
+  unsigned int delay;
+  uint32_t base;
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdbitmap[level] == 0)
+        {
+          continue;
+        }
+
+      base  = g_wdtick >> WHEEL_SHIFT(level);
+      delay = wd_wheel_distance(g_wdbitmap[level], base & WHEEL_MASK);
+      delay = ((base + delay) << WHEEL_SHIFT(level)) - g_wdtick;
+
+      if (next == 0 || delay < next)
+        {
+          next = delay;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_skip
+ *
+ * Description:
+ *   Advance the wheel by a number of ticks in one go.  There must not be
+ *   any event of the wheel in that interval (see wd_wheel_next()).
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_skip(unsigned int ticks)
+{
+  g_wdtick += ticks;
+}
+
+#endif /* CONFIG_WDOG_TIMING_WHEEL */
@@ -88,6 +88,15 @@ extern sq_queue_t g_wdactivelist;
 
 extern uint16_t g_wdnfree;
 
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+/* With CONFIG_WDOG_TIMING_WHEEL, active watchdogs are kept in a timing
+ * wheel instead of g_wdactivelist.  This is the current time of the wheel,
+ * in ticks.
+ */
+
+extern uint32_t g_wdtick;
+#endif
+
 /************************************************************************
  * Public Function Prototypes
  ************************************************************************/
@@ -144,6 +153,24 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Timing wheel
+ *
+ * Description:
+ *   Internal interfaces of the timing wheel (see wd_wheel.c).  All of them
+ *   must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMING_WHEEL
+void wd_wheel_add(FAR struct wdog_s *wdog);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+void wd_wheel_tick(void);
+FAR struct wdog_s *wd_wheel_expired(void);
+unsigned int wd_wheel_next(void);
+void wd_wheel_skip(unsigned int ticks);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,213 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2016 Motorola Mobility, LLC
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+# 3. Neither the name of the copyright holder nor the names of its
+# contributors may be used to endorse or promote products derived from this
+# software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+# THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+# OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+# OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Report the heap usage recorded with CONFIG_MM_TRACE.
+#
+# Usage:
+#   heaptrace.py [-e nuttx] sites <dump> [<later dump>]
+#   heaptrace.py [-e nuttx] trace <dump>
+#
+# The dumps are the output of 'cat /proc/heap/sites' or 'cat /proc/heap/trace'
+# captured from the console; other lines in them are ignored.  The caller
+# addresses are resolved with addr2line when the ELF file of the firmware is
+# given (set ADDR2LINE to use a cross addr2line, by default
+# arm-none-eabi-addr2line).
+#
+# 'sites' lists the top consumers of the heap.  Given two dumps taken some
+# time apart, it lists the call sites whose live memory grew in between,
+# which are the first suspects of a leak.
+#
+# 'trace' replays the events of the ring and lists, by call site, the
+# allocations that were not freed by the end of it.
+#
+from __future__ import print_function
+import os
+import re
+import sys
+import subprocess
+from collections import defaultdict
+
+SITE_RE = re.compile(r'^\s*(0x[0-9a-fA-F]+|other)\s+(\d+)\s+(\d+)\s+(\d+)\s*$')
+EVENT_RE = re.compile(r'^\s*(\d+)\s+(-?\d+)\s+(0x[0-9a-fA-F]+)\s+'
+                      r'(0x[0-9a-fA-F]+)\s+(\d+)\s*$')
+
+class Symbolizer:
+    "resolve caller addresses with addr2line, if an ELF file is given"
+
+    def __init__(self, elf):
+        self.elf = elf
+        self.cache = {}
+
+    def resolve(self, callers):
+        todo = [c for c in callers
+                if c not in self.cache and c.startswith('0x')]
+        if not self.elf or not todo:
+            return
+
+        # Return addresses point after the call, and have the Thumb bit set
+        # on ARM:  look up the byte before.
+
+        addrs = ['0x{:x}'.format((int(c, 16) & ~1) - 1) for c in todo]
+        addr2line = os.environ.get('ADDR2LINE', 'arm-none-eabi-addr2line')
+        try:
+            out = subprocess.check_output([addr2line, '-f', '-s', '-e',
+                                           self.elf] + addrs)
+        except (OSError, subprocess.CalledProcessError) as e:
+            print("warning: {} failed: {}".format(addr2line, e),
+                  file=sys.stderr)
+            self.elf = None
+            return
+
+        lines = out.decode('utf-8', 'replace').splitlines()
+        for i, c in enumerate(todo):
+            if 2 * i + 1 < len(lines):
+                self.cache[c] = '{} ({})'.format(lines[2 * i],
+                                                 lines[2 * i + 1])
+
+    def name(self, caller):
+        if caller in self.cache:
+            return '{} {}'.format(caller, self.cache[caller])
+        return caller
+
+def read_sites(path):
+    "return a dictionary of caller: (count, bytes, age)"
+    sites = {}
+    with open(path) as f:
+        for line in f:
+            m = SITE_RE.match(line)
+            if m:
+                sites[m.group(1)] = (int(m.group(2)), int(m.group(3)),
+                                     int(m.group(4)))
+    return sites
+
+def read_events(path):
+    "return a list of (time, pid, caller, mem, size), oldest first"
+    events = []
+    with open(path) as f:
+        for line in f:
+            m = EVENT_RE.match(line)
+            if m:
+                events.append((int(m.group(1)), int(m.group(2)), m.group(3),
+                               m.group(4), int(m.group(5))))
+    return events
+
+def report_sites(sym, paths):
+    sites = read_sites(paths[0])
+    if len(paths) == 1:
+        sym.resolve(sites.keys())
+        total = sum(s[1] for s in sites.values())
+        print('{:>10} {:>8} {:>6}  {}'.format('Bytes', 'Count', 'Age',
+                                             'Caller'))
+        for caller, (count, nbytes, age) in sorted(sites.items(),
+                key=lambda s: s[1][1], reverse=True):
+            print('{:>10} {:>8} {:>6}  {}'.format(nbytes, count, age,
+                                                 sym.name(caller)))
+        print('{:>10} bytes in use'.format(total))
+        return
+
+    # Compare with a later dump
+
+    later = read_sites(paths[1])
+    growth = []
+    for caller in set(sites) | set(later):
+        before = sites.get(caller, (0, 0, 0))
+        after = later.get(caller, (0, 0, 0))
+        if after[1] > before[1]:
+            growth.append((after[1] - before[1], after[0] - before[0],
+                           caller))
+
+    sym.resolve([g[2] for g in growth])
+    print('{:>10} {:>8}  {}'.format('Growth', 'Count', 'Caller'))
+    for nbytes, count, caller in sorted(growth, reverse=True):
+        print('{:>10} {:>8}  {}'.format(nbytes, count, sym.name(caller)))
+
+def report_trace(sym, path):
+    events = read_events(path)
+    live = {}
+    allocs = defaultdict(lambda: [0, 0])
+
+    # Frees are the events with a zero size.  The frees of memory allocated
+    # before the start of the ring are ignored.
+
+    for time, pid, caller, mem, size in events:
+        if size == 0:
+            live.pop(mem, None)
+        else:
+            live[mem] = (time, pid, caller, size)
+            allocs[caller][0] += 1
+            allocs[caller][1] += size
+
+    leaks = defaultdict(list)
+    for mem, (time, pid, caller, size) in live.items():
+        leaks[caller].append((time, pid, mem, size))
+
+    sym.resolve(list(allocs.keys()))
+    if events:
+        print('{} events over {} ticks'.format(len(events),
+                                               events[-1][0] - events[0][0]))
+
+    print('\nAllocations by call site:')
+    print('{:>10} {:>8}  {}'.format('Bytes', 'Count', 'Caller'))
+    for caller, (count, nbytes) in sorted(allocs.items(),
+            key=lambda a: a[1][1], reverse=True):
+        print('{:>10} {:>8}  {}'.format(nbytes, count, sym.name(caller)))
+
+    print('\nNot freed by the end of the trace:')
+    print('{:>10} {:>8}  {}'.format('Bytes', 'Count', 'Caller'))
+    for caller, blocks in sorted(leaks.items(),
+            key=lambda l: sum(b[3] for b in l[1]), reverse=True):
+        print('{:>10} {:>8}  {}'.format(sum(b[3] for b in blocks),
+                                       len(blocks), sym.name(caller)))
+        for time, pid, mem, size in sorted(blocks)[:4]:
+            print('{:>22}  {} bytes at {}, pid {}, time {}'.format(
+                  '', size, mem, pid, time))
+
+def usage(argv):
+    print('usage: {} [-e <elf>] sites <dump> [<later dump>]'.format(argv[0]))
+    print('       {} [-e <elf>] trace <dump>'.format(argv[0]))
+
+def main(argv):
+    args = argv[1:]
+    elf = None
+    if len(args) >= 2 and args[0] == '-e':
+        elf = args[1]
+        args = args[2:]
+
+    sym = Symbolizer(elf)
+    if len(args) in (2, 3) and args[0] == 'sites':
+        report_sites(sym, args[1:])
+    elif len(args) == 2 and args[0] == 'trace':
+        report_trace(sym, args[1])
+    else:
+        usage(argv)
+        return -1
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))